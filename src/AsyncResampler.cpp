@@ -0,0 +1,164 @@
+#include "AsyncResampler.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// Fenêtre de Kaiser : β = 8 donne environ 80 dB de réjection
+constexpr double kaiserBeta = 8.0;
+
+// Coupure relative à la fréquence de Nyquist de la plus lente des deux voies
+constexpr double cutoffRatio = 0.9;
+
+// Fonction de Bessel modifiée d'ordre 0 (série entière)
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-12) {
+            break;
+        }
+    }
+    return sum;
+}
+
+// Trames de sortie traitées par passe (état de phase tenu sur la pile)
+constexpr unsigned int passFrames = 64;
+
+} // namespace
+
+void AsyncResampler::prepare(unsigned int channelCount, double nominalRatio, unsigned int maxInput) {
+    channels = std::max(1u, channelCount);
+    maxInputFrames = maxInput;
+
+    // Sous-échantillonnage : la coupure suit la fréquence de sortie
+    double cutoff = 0.5 * cutoffRatio * std::min(1.0, 1.0 / nominalRatio);
+    double half = taps / 2.0;
+    double norm = besselI0(kaiserBeta);
+
+    // Coefficient de l'échantillon k trames avant le plus récent, pour la
+    // phase φ : noyau évalué à k - taps/2 + φ. Rangé du plus ancien au plus
+    // récent, dans l'ordre de la mémoire tampon.
+    table.assign((phases + 1) * taps, 0.0f);
+    for (unsigned int p = 0; p <= phases; p++) {
+        double phi = static_cast<double>(p) / phases;
+        double row[taps];
+        double sum = 0.0;
+        for (unsigned int k = 0; k < taps; k++) {
+            double d = k - half + phi;
+            double x = 2.0 * cutoff * d;
+            double sinc = (std::abs(x) < 1e-12) ? 1.0 : std::sin(M_PI * x) / (M_PI * x);
+            double r = d / half;
+            double window = (std::abs(r) < 1.0) ? besselI0(kaiserBeta * std::sqrt(1.0 - r * r)) / norm : 0.0;
+            row[k] = sinc * window;
+            sum += row[k];
+        }
+        // Gain unitaire en continu pour chaque phase
+        for (unsigned int k = 0; k < taps; k++) {
+            table[p * taps + (taps - 1 - k)] = static_cast<float>(row[k] / sum);
+        }
+    }
+
+    buffer.assign(static_cast<size_t>(channels) * (taps + maxInputFrames), 0.0f);
+    reset();
+}
+
+void AsyncResampler::reset() {
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    fraction = 0.0;
+}
+
+unsigned int AsyncResampler::inputFramesNeeded(unsigned int nFrames, double ratio) const {
+    // Même arithmétique que process() : compte exact, sans écart d'arrondi
+    double position = fraction;
+    unsigned int count = 0;
+    for (unsigned int n = 0; n < nFrames; n++) {
+        position += ratio;
+        while (position >= 1.0) {
+            position -= 1.0;
+            count++;
+        }
+    }
+    return count;
+}
+
+void AsyncResampler::process(float* output, const float* input, unsigned int nFrames, double ratio) {
+    const unsigned int inputFrames = inputFramesNeeded(nFrames, ratio);
+    const size_t stride = taps + maxInputFrames;
+
+    // Désentrelacer le bloc à la suite de l'historique : toutes les écritures
+    // précèdent les lectures, les fenêtres sont contiguës
+    for (unsigned int ch = 0; ch < channels; ch++) {
+        float* line = &buffer[ch * stride + taps];
+        for (unsigned int i = 0; i < inputFrames; i++) {
+            line[i] = input[i * channels + ch];
+        }
+    }
+
+    unsigned int consumed = 0;
+    for (unsigned int done = 0; done < nFrames; done += passFrames) {
+        unsigned int count = std::min(passFrames, nFrames - done);
+
+        // Passe scalaire : sous-filtre, poids d'interpolation et début de
+        // fenêtre (les taps trames précédant la prochaine à consommer)
+        unsigned int rows[passFrames];
+        float weights[passFrames];
+        unsigned int starts[passFrames];
+        for (unsigned int n = 0; n < count; n++) {
+            double position = fraction * phases;
+            unsigned int index = std::min(static_cast<unsigned int>(position), phases - 1);
+            rows[n] = index * taps;
+            weights[n] = static_cast<float>(position - index);
+            starts[n] = consumed;
+
+            // Avancer : chaque unité franchie consomme une trame d'entrée
+            fraction += ratio;
+            while (fraction >= 1.0) {
+                fraction -= 1.0;
+                consumed++;
+            }
+        }
+
+        // Passe vectorielle : fenêtres parcourues par groupes de lanes taps,
+        // un accumulateur par voie et par trame ; les sorties des deux
+        // sous-filtres voisins sont ensuite interpolées linéairement
+        for (unsigned int ch = 0; ch < channels; ch++) {
+            const float* line = &buffer[ch * stride];
+            alignas(64) float sums0[passFrames][lanes] = {};
+            alignas(64) float sums1[passFrames][lanes] = {};
+            for (unsigned int j = 0; j < taps; j += lanes) {
+                for (unsigned int n = 0; n < count; n++) {
+                    const float* row0 = &table[rows[n] + j];
+                    const float* row1 = row0 + taps;
+                    const float* window = line + starts[n] + j;
+                    for (unsigned int l = 0; l < lanes; l++) {
+                        sums0[n][l] += row0[l] * window[l];
+                        sums1[n][l] += row1[l] * window[l];
+                    }
+                }
+            }
+            float* out = output + static_cast<size_t>(done) * channels + ch;
+            for (unsigned int n = 0; n < count; n++) {
+                float y0 = 0.0f;
+                float y1 = 0.0f;
+                for (unsigned int l = 0; l < lanes; l++) {
+                    y0 += sums0[n][l];
+                    y1 += sums1[n][l];
+                }
+                out[n * channels] = y0 + weights[n] * (y1 - y0);
+            }
+        }
+    }
+
+    // Conserver les taps dernières trames comme historique du bloc suivant
+    for (unsigned int ch = 0; ch < channels; ch++) {
+        float* line = &buffer[ch * stride];
+        std::copy(line + consumed, line + consumed + taps, line);
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+// Rééchantillonneur asynchrone à rapport variable (ASRC).
+//
+// Noyau sinc fenêtré (Kaiser) décomposé en `phases` sous-filtres de `taps`
+// coefficients ; la phase fractionnaire est interpolée linéairement entre
+// deux sous-filtres voisins. Le rapport (trames d'entrée consommées par
+// trame produite) peut changer à chaque bloc sans discontinuité : c'est la
+// commande de la boucle de compensation de dérive.
+//
+// La position fractionnaire est tenue en double précision et renormalisée à
+// chaque trame consommée : aucune erreur ne s'accumule sur de longues durées.
+// Chaque bloc d'entrée est recopié à la suite de l'historique avant le
+// calcul : les fenêtres sont lues dans une mémoire contiguë, sans relire
+// un échantillon juste écrit.
+class AsyncResampler {
+public:
+    static constexpr unsigned int taps = 32;     // Multiple de lanes
+    static constexpr unsigned int phases = 256;
+    static constexpr unsigned int lanes = 8;
+    static_assert(taps % lanes == 0, "taps doit être un multiple de lanes");
+
+    // Hors du thread audio. nominalRatio : fréquence d'entrée / sortie,
+    // fixe la coupure anti-repliement. maxInputFrames : plus grand nombre
+    // de trames d'entrée consommées par un appel à process().
+    void prepare(unsigned int channels, double nominalRatio, unsigned int maxInputFrames);
+
+    // Oubli de l'historique (silence) et de la phase
+    void reset();
+
+    // Trames d'entrée que consommera process() pour nFrames à ce rapport
+    unsigned int inputFramesNeeded(unsigned int nFrames, double ratio) const;
+
+    // Thread audio : input contient exactement inputFramesNeeded(nFrames,
+    // ratio) trames entrelacées (au plus maxInputFrames) ; produit nFrames
+    // trames entrelacées
+    void process(float* output, const float* input, unsigned int nFrames, double ratio);
+
+    // Retard de groupe du noyau, en trames d'entrée
+    static constexpr unsigned int delayFrames() { return taps / 2; }
+
+private:
+    unsigned int channels = 1;
+
+    // Table des sous-filtres : (phases + 1) lignes de taps coefficients,
+    // ordonnées du plus ancien au plus récent
+    std::vector<float> table;
+
+    // Par canal : taps trames d'historique puis le bloc courant, du plus
+    // ancien au plus récent (lignes de taps + maxInputFrames)
+    std::vector<float> buffer;
+    unsigned int maxInputFrames = 0;
+    double fraction = 0.0;           // Position dans [0, 1) avant la prochaine trame
+};
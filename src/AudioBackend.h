@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Description d'un périphérique audio
+struct AudioDevice {
+    int id;
+    std::string name;
+    bool isInput;
+    bool isOutput;
+    bool isDefault;
+    unsigned int maxChannels;
+    std::vector<unsigned int> sampleRates;
+};
+
+// Drapeaux d'état transmis au callback de traitement
+enum AudioStreamStatus : unsigned int {
+    STREAM_OK = 0,
+    STREAM_INPUT_OVERFLOW = 1,    // Des échantillons d'entrée ont été perdus
+    STREAM_OUTPUT_UNDERFLOW = 2,  // La sortie a manqué de données
+    STREAM_INPUT_UNDERFLOW = 4    // L'entrée a manqué de données (complétée par du silence)
+};
+
+// Callback de traitement appelé par le backend pour chaque bloc.
+// Les tampons sont entrelacés (inputChannels / outputChannels canaux).
+using AudioProcessCallback = int (*)(float* output, const float* input,
+                                     unsigned int nFrames, double streamTime,
+                                     unsigned int status, void* userData);
+
+// Configuration d'un flux audio
+struct StreamConfig {
+    int inputDevice = -1;          // -1 : périphérique par défaut
+    int outputDevice = -1;
+    unsigned int inputChannels = 1;
+    unsigned int outputChannels = 2;
+    unsigned int sampleRate = 48000;
+    unsigned int bufferFrames = 128;
+    std::string streamName = "NoiseInverter";
+};
+
+// Interface commune des backends audio.
+// Le backend appelle le callback depuis son propre thread ; il peut ajuster
+// sampleRate et bufferFrames dans la configuration passée à open().
+class AudioBackend {
+public:
+    virtual ~AudioBackend() = default;
+
+    // Nom du backend (pour les messages)
+    virtual const char* name() const = 0;
+
+    // Liste les périphériques disponibles
+    virtual std::vector<AudioDevice> listDevices() = 0;
+
+    // Nom d'un seul périphérique (vide s'il n'existe pas). Les backends dont
+    // l'énumération est lente peuvent ne sonder que ce périphérique.
+    virtual std::string deviceName(int id) {
+        for (const AudioDevice& device : listDevices()) {
+            if (device.id == id) {
+                return device.name;
+            }
+        }
+        return std::string();
+    }
+
+    // Ouvre / démarre / arrête / ferme le flux
+    virtual bool open(StreamConfig& config, AudioProcessCallback callback, void* userData) = 0;
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual void close() = 0;
+
+    // Vrai tant que le flux produit des callbacks. Un flux démarré qui
+    // s'arrête sans isFinished() a été interrompu (périphérique perdu).
+    virtual bool isRunning() const = 0;
+
+    // Vrai lorsqu'une source finie (fichier, pipe) est épuisée
+    virtual bool isFinished() const { return false; }
+
+    // Vrai si le flux est cadencé par une horloge (périphérique, minuterie) ;
+    // seuls ces flux peuvent être rouverts sans perdre de données
+    virtual bool isRealtime() const { return true; }
+
+    // Latence ajoutée par le backend en plus des tampons du flux (files
+    // intermédiaires, conversion), en trames de sortie
+    virtual unsigned int extraLatencyFrames() const { return 0; }
+};
@@ -0,0 +1,46 @@
+#include "BufferSizeController.h"
+#include <algorithm>
+
+void BufferSizeController::reset(unsigned int frames) {
+    currentFrames = std::max(settings.minFrames, std::min(settings.maxFrames, frames));
+    stableWindows = 0;
+    bannedBelow = 0;
+    banRemaining = 0;
+}
+
+unsigned int BufferSizeController::update(float maxLoad, unsigned int xruns) {
+    if (banRemaining > 0 && --banRemaining == 0) {
+        bannedBelow = 0;
+    }
+
+    // Dépassements : agrandir et bannir la taille courante
+    if (xruns >= settings.xrunsToGrow || maxLoad > settings.loadToGrow) {
+        stableWindows = 0;
+        if (xruns > 0) {
+            bannedBelow = std::max(bannedBelow, currentFrames * 2);
+            banRemaining = settings.banWindows;
+        }
+        if (currentFrames * 2 <= settings.maxFrames) {
+            currentFrames *= 2;
+            return currentFrames;
+        }
+        return 0;
+    }
+
+    // Marge suffisante : réduire après plusieurs fenêtres stables.
+    // La charge double approximativement quand le tampon est divisé par deux.
+    if (xruns == 0 && maxLoad < settings.loadToShrink) {
+        stableWindows++;
+        unsigned int smaller = currentFrames / 2;
+        if (stableWindows >= settings.stableWindowsToShrink &&
+            smaller >= settings.minFrames && smaller >= bannedBelow) {
+            stableWindows = 0;
+            currentFrames = smaller;
+            return currentFrames;
+        }
+        return 0;
+    }
+
+    stableWindows = 0;
+    return 0;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// Contrôleur de taille de tampon adaptative.
+//
+// Observe, par fenêtre, la charge maximale du callback (durée / période) et
+// le nombre de xruns. Double la taille après des dépassements répétés ou une
+// charge trop élevée ; la divise par deux lorsque la marge est durablement
+// suffisante. Une taille qui a provoqué des xruns est bannie pendant un
+// temps pour éviter les oscillations.
+class BufferSizeController {
+public:
+    struct Settings {
+        unsigned int minFrames = 32;
+        unsigned int maxFrames = 2048;
+        unsigned int xrunsToGrow = 2;        // xruns par fenêtre pour agrandir
+        float loadToGrow = 0.75f;            // charge max pour agrandir
+        float loadToShrink = 0.30f;          // charge max pour réduire
+        unsigned int stableWindowsToShrink = 20;
+        unsigned int banWindows = 600;       // durée du bannissement d'une taille
+    };
+
+    BufferSizeController() = default;
+    explicit BufferSizeController(const Settings& settings) : settings(settings) {}
+
+    // Réinitialise l'historique pour une taille courante donnée
+    void reset(unsigned int currentFrames);
+
+    // Aligne la taille courante sur celle effectivement obtenue,
+    // sans effacer l'historique
+    void syncCurrentFrames(unsigned int frames) { currentFrames = frames; }
+
+    // Analyse une fenêtre ; retourne la nouvelle taille ou 0 si inchangée
+    unsigned int update(float maxLoad, unsigned int xruns);
+
+    unsigned int getCurrentFrames() const { return currentFrames; }
+    const Settings& getSettings() const { return settings; }
+
+private:
+    Settings settings;
+    unsigned int currentFrames = 0;
+    unsigned int stableWindows = 0;
+
+    // Plus petite taille ayant provoqué des xruns, et fenêtres restantes
+    unsigned int bannedBelow = 0;
+    unsigned int banRemaining = 0;
+};
@@ -0,0 +1,57 @@
+#include "EngineArena.h"
+#include <cstring>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+EngineArena::~EngineArena() {
+    release();
+}
+
+bool EngineArena::allocate() {
+    release();
+    if (reserved == 0) {
+        return true;
+    }
+
+    memory = static_cast<unsigned char*>(::operator new(reserved, std::align_val_t(alignment), std::nothrow));
+    if (!memory) {
+        return false;
+    }
+    capacity = reserved;
+
+    // Écrire chaque page maintenant plutôt qu'au premier bloc
+    std::memset(memory, 0, capacity);
+    return true;
+}
+
+void EngineArena::release() {
+    unlock();
+    if (memory) {
+        ::operator delete(memory, std::align_val_t(alignment));
+        memory = nullptr;
+    }
+    capacity = 0;
+}
+
+bool EngineArena::lock() {
+    if (locked || !memory) {
+        return locked;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    locked = (mlock(memory, capacity) == 0);
+#endif
+    return locked;
+}
+
+void EngineArena::unlock() {
+    if (!locked) {
+        return;
+    }
+#if defined(__unix__) || defined(__APPLE__)
+    munlock(memory, capacity);
+#endif
+    locked = false;
+}
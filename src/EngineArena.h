@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+
+// Zone mémoire unique pour l'état du moteur.
+//
+// Les tampons sont d'abord réservés (décalages alignés sur une ligne de
+// cache, dans l'ordre des réservations : l'état lu à chaque bloc est
+// réservé en premier et reste contigu), puis alloués d'un seul tenant.
+// L'allocation remplit la zone de zéros, ce qui touche chaque page ; lock()
+// la verrouille ensuite en mémoire physique. Le thread audio ne subit ainsi
+// ni défaut de page ni appel à l'allocateur.
+class EngineArena {
+public:
+    static constexpr size_t alignment = 64;
+
+    EngineArena() = default;
+    ~EngineArena();
+
+    EngineArena(const EngineArena&) = delete;
+    EngineArena& operator=(const EngineArena&) = delete;
+
+    // Oublie la disposition (la mémoire reste valide jusqu'à allocate())
+    void reset() { reserved = 0; }
+
+    // Réserve count éléments de T, retourne leur décalage
+    template <typename T>
+    size_t reserve(size_t count) {
+        size_t offset = reserved;
+        reserved += (count * sizeof(T) + alignment - 1) / alignment * alignment;
+        return offset;
+    }
+
+    // Alloue la zone pour la disposition courante (mise à zéro) ; libère
+    // la précédente, dont les pointeurs deviennent invalides
+    bool allocate();
+    void release();
+
+    // Verrouillage en mémoire physique (peut être refusé : RLIMIT_MEMLOCK)
+    bool lock();
+    void unlock();
+    bool isLocked() const { return locked; }
+
+    template <typename T>
+    T* at(size_t offset) const { return reinterpret_cast<T*>(memory + offset); }
+
+    size_t size() const { return capacity; }
+
+private:
+    unsigned char* memory = nullptr;
+    size_t capacity = 0;
+    size_t reserved = 0;
+    bool locked = false;
+};
+
+// Vue sur un tableau de l'arène (interface minimale d'un std::vector)
+template <typename T>
+class ArenaSpan {
+public:
+    ArenaSpan() = default;
+    ArenaSpan(T* data, size_t count) : pointer(data), count(count) {}
+
+    T* data() const { return pointer; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T* begin() const { return pointer; }
+    T* end() const { return pointer + count; }
+    T& operator[](size_t index) const { return pointer[index]; }
+
+private:
+    T* pointer = nullptr;
+    size_t count = 0;
+};
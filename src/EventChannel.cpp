@@ -0,0 +1,214 @@
+#include "EventChannel.h"
+#include "Trace.h"
+#include <algorithm>
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Descripteurs de notification : eventfd (une seule extrémité) ou tube non bloquant
+bool openNotifier(int& readFd, int& writeFd) {
+#if defined(__linux__)
+    readFd = writeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    return readFd >= 0;
+#elif defined(__unix__) || defined(__APPLE__)
+    int fds[2];
+    if (pipe(fds) != 0) {
+        return false;
+    }
+    for (int fd : fds) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    readFd = fds[0];
+    writeFd = fds[1];
+    return true;
+#else
+    readFd = writeFd = -1;
+    return false;
+#endif
+}
+
+void closeNotifier(int& readFd, int& writeFd) {
+#if defined(__unix__) || defined(__APPLE__)
+    if (writeFd >= 0 && writeFd != readFd) {
+        close(writeFd);
+    }
+    if (readFd >= 0) {
+        close(readFd);
+    }
+#endif
+    readFd = writeFd = -1;
+}
+
+// Écriture non bloquante : un compteur eventfd ne peut pas déborder ici, un
+// tube plein signifie que le lecteur a déjà une notification en attente
+void notify(int writeFd) {
+#if defined(__linux__)
+    eventfd_write(writeFd, 1);
+#elif defined(__unix__) || defined(__APPLE__)
+    const char byte = 1;
+    ssize_t written = write(writeFd, &byte, 1);
+    (void)written;
+#else
+    (void)writeFd;
+#endif
+}
+
+void drain(int readFd) {
+#if defined(__linux__)
+    eventfd_t value;
+    eventfd_read(readFd, &value);
+#elif defined(__unix__) || defined(__APPLE__)
+    char buffer[64];
+    while (read(readFd, buffer, sizeof(buffer)) > 0) {
+    }
+#else
+    (void)readFd;
+#endif
+}
+
+// Attente d'un descripteur lisible (timeoutMs < 0 : sans limite)
+void waitReadable(int fd, int timeoutMs) {
+#if defined(__unix__) || defined(__APPLE__)
+    if (fd >= 0) {
+        struct pollfd entry = {fd, POLLIN, 0};
+        poll(&entry, 1, timeoutMs);
+        return;
+    }
+#endif
+    (void)fd;
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs < 0 ? 10 : timeoutMs));
+}
+
+} // namespace
+
+EventChannel::Subscription::Subscription(uint32_t mask) : mask(mask) {
+    openNotifier(readFd, writeFd);
+}
+
+EventChannel::Subscription::~Subscription() {
+    closeNotifier(readFd, writeFd);
+}
+
+// Distributeur : signale le descripteur pour le premier événement en attente
+void EventChannel::Subscription::deliver(uint32_t events) {
+    events &= mask;
+    if (events != 0 && pending.fetch_or(events, std::memory_order_acq_rel) == 0 && writeFd >= 0) {
+        notify(writeFd);
+    }
+}
+
+uint32_t EventChannel::Subscription::take() {
+    if (readFd >= 0) {
+        drain(readFd);
+    }
+    return pending.exchange(0, std::memory_order_acq_rel);
+}
+
+uint32_t EventChannel::Subscription::wait(int timeoutMs) {
+    if (pending.load(std::memory_order_acquire) == 0) {
+        waitReadable(readFd, timeoutMs);
+    }
+    return take();
+}
+
+EventChannel::EventChannel() {
+    openNotifier(doorbellRead, doorbellWrite);
+}
+
+EventChannel::~EventChannel() {
+    stopping = true;
+    if (dispatcher.joinable()) {
+        if (doorbellWrite >= 0) {
+            notify(doorbellWrite);
+        }
+        dispatcher.join();
+    }
+    closeNotifier(doorbellRead, doorbellWrite);
+}
+
+std::shared_ptr<EventChannel::Subscription> EventChannel::subscribe(uint32_t mask) {
+    std::shared_ptr<Subscription> subscription(new Subscription(mask));
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        subscriptions.push_back(subscription);
+    }
+    startDispatcher();
+    return subscription;
+}
+
+void EventChannel::unsubscribe(const std::shared_ptr<Subscription>& subscription) {
+    std::lock_guard<std::mutex> lock(mutex);
+    subscriptions.erase(std::remove(subscriptions.begin(), subscriptions.end(), subscription),
+                        subscriptions.end());
+}
+
+void EventChannel::setCallback(std::function<void(uint32_t)> newCallback) {
+    bool start;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        callback = std::move(newCallback);
+        start = static_cast<bool>(callback);
+    }
+    if (start) {
+        startDispatcher();
+    }
+}
+
+// Réveil du distributeur pour un événement urgent
+void EventChannel::ring() {
+    wakes.fetch_add(1, std::memory_order_relaxed);
+    if (doorbellWrite >= 0) {
+        notify(doorbellWrite);
+    }
+}
+
+void EventChannel::startDispatcher() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!dispatcher.joinable()) {
+        dispatcher = std::thread(&EventChannel::dispatchThread, this);
+    }
+}
+
+void EventChannel::dispatchThread() {
+    trace::setThreadName("événements");
+
+    while (!stopping.load(std::memory_order_acquire)) {
+        // Événements fusionnés depuis le cycle précédent
+        uint32_t events = state.exchange(ACTIVE, std::memory_order_acq_rel) & ALL_EVENTS;
+        if (events != 0) {
+            NI_TRACE_SCOPE("distribution", events);
+            dispatches.fetch_add(1, std::memory_order_relaxed);
+            std::function<void(uint32_t)> current;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (const auto& subscription : subscriptions) {
+                    subscription->deliver(events);
+                }
+                current = callback;
+            }
+            // Hors verrou : la fonction peut modifier les abonnements
+            if (current) {
+                current(events);
+            }
+        }
+
+        // Cycle suivant à l'échéance (milliseconde entière au moins), plus
+        // tôt pour un événement urgent ou l'arrêt
+        int64_t interval = minimumInterval.load(std::memory_order_relaxed);
+        int timeoutMs = static_cast<int>(std::max<int64_t>(1, (interval + 999) / 1000));
+        waitReadable(doorbellRead, timeoutMs);
+        if (doorbellRead >= 0) {
+            drain(doorbellRead);
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Notifications du moteur vers l'interface, hors du thread audio.
+//
+// Le thread audio publie les événements d'un bloc par un seul fetch_or sur
+// un mot d'état : les événements sont fusionnés jusqu'à leur lecture, quel
+// que soit le nombre d'abonnés. Un thread de distribution répartit ensuite
+// les événements entre les abonnés, chacun disposant d'un descripteur
+// (eventfd sous Linux, tube ailleurs) à surveiller avec poll ou epoll, au
+// rythme de son choix.
+//
+// Le distributeur relève le mot d'état à son propre rythme (attente bornée
+// à minimumInterval) : le thread audio ne fait aucun appel système, quelle
+// que soit la période des blocs. Seuls les événements urgents (XRUN,
+// STREAM_RECOVERED) le réveillent avant l'échéance, une fois par cycle.
+class EventChannel {
+public:
+    enum Event : uint32_t {
+        VISUALIZATION = 1u << 0,        // Nouvelles données de visualisation
+        METER = 1u << 1,                // Niveaux de sortie mis à jour
+        XRUN = 1u << 2,                 // Débordement ou manque signalé par le backend
+        PARAMETERS_APPLIED = 1u << 3,   // Paramètres pris en compte par le thread audio
+        STREAM_RECOVERED = 1u << 4,     // Flux rétabli par la surveillance après une panne
+        URGENT_EVENTS = XRUN | STREAM_RECOVERED,
+        ALL_EVENTS = 0xFFFFu
+    };
+
+    // Abonné : descripteur lisible lorsqu'au moins un événement attend
+    class Subscription {
+    public:
+        ~Subscription();
+
+        Subscription(const Subscription&) = delete;
+        Subscription& operator=(const Subscription&) = delete;
+
+        // Descripteur pour poll / epoll (POLLIN), -1 sans support du système
+        int fd() const { return readFd; }
+
+        // Événements accumulés depuis le dernier appel (0 si aucun)
+        uint32_t take();
+
+        // Attend un événement (timeoutMs < 0 : sans limite), puis take()
+        uint32_t wait(int timeoutMs);
+
+    private:
+        friend class EventChannel;
+        explicit Subscription(uint32_t mask);
+        void deliver(uint32_t events);
+
+        uint32_t mask;
+        std::atomic<uint32_t> pending{0};
+        int readFd = -1;
+        int writeFd = -1;
+    };
+
+    EventChannel();
+    ~EventChannel();
+
+    EventChannel(const EventChannel&) = delete;
+    EventChannel& operator=(const EventChannel&) = delete;
+
+    // Thread audio : une opération atomique ; un réveil seulement pour le
+    // premier événement urgent du cycle, distributeur démarré
+    void post(uint32_t events) {
+        if (events == 0) {
+            return;
+        }
+        uint32_t previous = state.fetch_or(events, std::memory_order_acq_rel);
+        if ((events & URGENT_EVENTS) != 0 && (previous & (ACTIVE | URGENT_EVENTS)) == ACTIVE) {
+            ring();
+        }
+    }
+
+    // Abonnements (hors thread audio) ; le distributeur démarre au premier
+    std::shared_ptr<Subscription> subscribe(uint32_t mask = ALL_EVENTS);
+    void unsubscribe(const std::shared_ptr<Subscription>& subscription);
+
+    // Fonction appelée par le distributeur à chaque cycle porteur d'événements
+    void setCallback(std::function<void(uint32_t)> callback);
+
+    // Intervalle entre deux cycles de distribution (hors événement urgent)
+    void setMinimumInterval(std::chrono::microseconds interval) { minimumInterval.store(interval.count()); }
+
+    // Cycles de distribution et réveils pour un événement urgent
+    uint64_t getDispatchCount() const { return dispatches.load(std::memory_order_relaxed); }
+    uint64_t getWakeCount() const { return wakes.load(std::memory_order_relaxed); }
+
+private:
+    // Bit de contrôle du mot d'état (au-dessus des événements)
+    static constexpr uint32_t ACTIVE = 1u << 30;      // Distributeur démarré
+
+    void ring();
+    void startDispatcher();
+    void dispatchThread();
+
+    std::atomic<uint32_t> state{0};
+    std::atomic<uint64_t> wakes{0};
+    std::atomic<uint64_t> dispatches{0};
+    std::atomic<int64_t> minimumInterval{10000};
+
+    // Réveil du distributeur
+    int doorbellRead = -1;
+    int doorbellWrite = -1;
+
+    std::mutex mutex;   // Abonnés et fonction (jamais pris par le thread audio)
+    std::vector<std::shared_ptr<Subscription>> subscriptions;
+    std::function<void(uint32_t)> callback;
+    std::thread dispatcher;
+    std::atomic<bool> stopping{false};
+};
@@ -0,0 +1,256 @@
+#include "FileBackend.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void writeU16(std::FILE* f, uint16_t v) {
+    uint8_t b[2] = {static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8)};
+    std::fwrite(b, 1, 2, f);
+}
+
+void writeU32(std::FILE* f, uint32_t v) {
+    uint8_t b[4] = {static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8),
+                    static_cast<uint8_t>(v >> 16), static_cast<uint8_t>(v >> 24)};
+    std::fwrite(b, 1, 4, f);
+}
+
+} // namespace
+
+FileBackend::FileBackend(const std::string& inputPath, const std::string& outputPath, bool paced)
+    : inputPath(inputPath), outputPath(outputPath), paced(paced) {
+}
+
+FileBackend::~FileBackend() {
+    stop();
+    close();
+}
+
+std::vector<AudioDevice> FileBackend::listDevices() {
+    AudioDevice input;
+    input.id = 0;
+    input.name = inputPath;
+    input.isInput = true;
+    input.isOutput = false;
+    input.isDefault = true;
+    input.maxChannels = fileChannels;
+    if (fileSampleRate > 0) {
+        input.sampleRates = {fileSampleRate};
+    }
+
+    AudioDevice output = input;
+    output.id = 1000;
+    output.name = outputPath;
+    output.isInput = false;
+    output.isOutput = true;
+    output.maxChannels = 32;
+
+    return {input, output};
+}
+
+// Charge le fichier WAV d'entrée en mémoire
+bool FileBackend::loadInput() {
+    std::FILE* f = std::fopen(inputPath.c_str(), "rb");
+    if (!f) {
+        std::cerr << "Erreur: impossible d'ouvrir " << inputPath << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> data;
+    uint8_t chunk[65536];
+    size_t count;
+    while ((count = std::fread(chunk, 1, sizeof(chunk), f)) > 0) {
+        data.insert(data.end(), chunk, chunk + count);
+    }
+    std::fclose(f);
+
+    if (data.size() < 12 || std::memcmp(data.data(), "RIFF", 4) != 0 ||
+        std::memcmp(data.data() + 8, "WAVE", 4) != 0) {
+        std::cerr << "Erreur: " << inputPath << " n'est pas un fichier WAV" << std::endl;
+        return false;
+    }
+
+    uint16_t formatTag = 0;
+    uint16_t bitsPerSample = 0;
+    const uint8_t* samples = nullptr;
+    size_t sampleBytes = 0;
+
+    // Parcourir les chunks RIFF
+    size_t pos = 12;
+    while (pos + 8 <= data.size()) {
+        const uint8_t* header = data.data() + pos;
+        uint32_t size = readU32(header + 4);
+        size_t available = std::min<size_t>(size, data.size() - pos - 8);
+
+        if (std::memcmp(header, "fmt ", 4) == 0 && available >= 16) {
+            formatTag = readU16(header + 8);
+            fileChannels = readU16(header + 10);
+            fileSampleRate = readU32(header + 12);
+            bitsPerSample = readU16(header + 22);
+            // WAVE_FORMAT_EXTENSIBLE : le vrai format est dans le sous-format
+            if (formatTag == 0xFFFE && available >= 26) {
+                formatTag = readU16(header + 32);
+            }
+        } else if (std::memcmp(header, "data", 4) == 0) {
+            samples = header + 8;
+            sampleBytes = available;
+        }
+
+        pos += 8 + size + (size & 1);
+    }
+
+    bool supported = fileChannels > 0 && samples &&
+                     ((formatTag == 1 && (bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32)) ||
+                      (formatTag == 3 && bitsPerSample == 32));
+    if (!supported) {
+        std::cerr << "Erreur: format WAV non supporté (" << formatTag << ", "
+                  << bitsPerSample << " bits)" << std::endl;
+        return false;
+    }
+
+    // Conversion en float
+    size_t bytesPerSample = bitsPerSample / 8;
+    size_t total = sampleBytes / bytesPerSample;
+    fileFrames = total / fileChannels;
+    inputSamples.resize(fileFrames * fileChannels);
+
+    for (size_t i = 0; i < inputSamples.size(); i++) {
+        const uint8_t* p = samples + i * bytesPerSample;
+        float value = 0.0f;
+        if (formatTag == 3) {
+            uint32_t bits = readU32(p);
+            std::memcpy(&value, &bits, sizeof(value));
+        } else if (bitsPerSample == 16) {
+            value = static_cast<int16_t>(readU16(p)) / 32768.0f;
+        } else if (bitsPerSample == 24) {
+            int32_t v = static_cast<int32_t>((p[0] << 8) | (p[1] << 16) | (p[2] << 24)) >> 8;
+            value = v / 8388608.0f;
+        } else {
+            value = static_cast<int32_t>(readU32(p)) / 2147483648.0f;
+        }
+        inputSamples[i] = value;
+    }
+
+    return true;
+}
+
+// En-tête WAV float 32 bits (réécrit à la fermeture avec la taille finale)
+void FileBackend::writeHeader(uint32_t dataBytes) {
+    uint16_t channels = static_cast<uint16_t>(config.outputChannels);
+    uint32_t byteRate = config.sampleRate * channels * sizeof(float);
+
+    std::fseek(outputFile, 0, SEEK_SET);
+    std::fwrite("RIFF", 1, 4, outputFile);
+    writeU32(outputFile, 36 + dataBytes);
+    std::fwrite("WAVE", 1, 4, outputFile);
+    std::fwrite("fmt ", 1, 4, outputFile);
+    writeU32(outputFile, 16);
+    writeU16(outputFile, 3);  // IEEE float
+    writeU16(outputFile, channels);
+    writeU32(outputFile, config.sampleRate);
+    writeU32(outputFile, byteRate);
+    writeU16(outputFile, static_cast<uint16_t>(channels * sizeof(float)));
+    writeU16(outputFile, 32);
+    std::fwrite("data", 1, 4, outputFile);
+    writeU32(outputFile, dataBytes);
+}
+
+bool FileBackend::open(StreamConfig& streamConfig, AudioProcessCallback processCallback, void* userData) {
+    if (!loadInput()) {
+        return false;
+    }
+
+    // Le flux adopte la fréquence du fichier
+    streamConfig.sampleRate = fileSampleRate;
+    config = streamConfig;
+    callback = processCallback;
+    callbackUserData = userData;
+
+    outputFile = std::fopen(outputPath.c_str(), "wb");
+    if (!outputFile) {
+        std::cerr << "Erreur: impossible de créer " << outputPath << std::endl;
+        return false;
+    }
+    outputBytes = 0;
+    writeHeader(0);
+
+    inputBuffer.assign(config.bufferFrames * config.inputChannels, 0.0f);
+    outputBuffer.assign(config.bufferFrames * config.outputChannels, 0.0f);
+
+    std::cout << "Fichier d'entrée: " << inputPath << " (" << fileChannels << " canaux, "
+              << fileSampleRate << " Hz, " << fileFrames << " trames)" << std::endl;
+
+    finished = false;
+    return true;
+}
+
+bool FileBackend::start() {
+    if (running || !outputFile) {
+        return running;
+    }
+    running = true;
+    thread = std::thread(&FileBackend::processThread, this);
+    return true;
+}
+
+void FileBackend::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void FileBackend::close() {
+    if (outputFile) {
+        writeHeader(outputBytes);
+        std::fclose(outputFile);
+        outputFile = nullptr;
+    }
+}
+
+void FileBackend::processThread() {
+    const unsigned int nFrames = config.bufferFrames;
+    const auto period = std::chrono::duration<double>(static_cast<double>(nFrames) / config.sampleRate);
+    auto deadline = std::chrono::steady_clock::now();
+    size_t frame = 0;
+
+    while (running && frame < fileFrames) {
+        size_t count = std::min<size_t>(nFrames, fileFrames - frame);
+
+        // Répartir les canaux du fichier sur les canaux d'entrée du flux
+        std::fill(inputBuffer.begin(), inputBuffer.end(), 0.0f);
+        for (size_t i = 0; i < count; i++) {
+            for (unsigned int c = 0; c < config.inputChannels; c++) {
+                unsigned int source = std::min(c, fileChannels - 1);
+                inputBuffer[i * config.inputChannels + c] = inputSamples[(frame + i) * fileChannels + source];
+            }
+        }
+
+        double streamTime = static_cast<double>(frame) / config.sampleRate;
+        callback(outputBuffer.data(), inputBuffer.data(), nFrames, streamTime, STREAM_OK, callbackUserData);
+
+        size_t bytes = count * config.outputChannels * sizeof(float);
+        std::fwrite(outputBuffer.data(), 1, bytes, outputFile);
+        outputBytes += static_cast<uint32_t>(bytes);
+        frame += count;
+
+        if (paced) {
+            deadline += std::chrono::duration_cast<std::chrono::steady_clock::duration>(period);
+            std::this_thread::sleep_until(deadline);
+        }
+    }
+
+    finished = true;
+    running = false;
+}
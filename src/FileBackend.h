@@ -0,0 +1,61 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Backend fichier : lit un WAV (PCM 16/24/32 bits ou float 32 bits) et écrit
+// le résultat dans un WAV float 32 bits. Le traitement se fait aussi vite que
+// possible, ou au rythme réel si `paced` est vrai.
+// La fréquence d'échantillonnage du flux est celle du fichier d'entrée.
+class FileBackend : public AudioBackend {
+public:
+    FileBackend(const std::string& inputPath, const std::string& outputPath, bool paced = false);
+    ~FileBackend() override;
+
+    const char* name() const override { return "file"; }
+
+    std::vector<AudioDevice> listDevices() override;
+
+    bool open(StreamConfig& config, AudioProcessCallback callback, void* userData) override;
+    bool start() override;
+    void stop() override;
+    void close() override;
+
+    bool isRunning() const override { return running; }
+    bool isFinished() const override { return finished; }
+    bool isRealtime() const override { return false; }
+
+private:
+    bool loadInput();
+    void processThread();
+    void writeHeader(uint32_t dataBytes);
+
+    std::string inputPath;
+    std::string outputPath;
+    bool paced;
+
+    StreamConfig config;
+    AudioProcessCallback callback = nullptr;
+    void* callbackUserData = nullptr;
+
+    // Contenu du fichier d'entrée (converti en float, entrelacé)
+    std::vector<float> inputSamples;
+    unsigned int fileChannels = 0;
+    unsigned int fileSampleRate = 0;
+    size_t fileFrames = 0;
+
+    std::FILE* outputFile = nullptr;
+    uint32_t outputBytes = 0;
+
+    std::vector<float> inputBuffer;
+    std::vector<float> outputBuffer;
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> finished{false};
+};
@@ -0,0 +1,227 @@
+#pragma once
+
+#include "ProcessingKernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+// Chaîne large bande en virgule fixe, pour les cartes où le calcul
+// flottant est lent ou coûteux en énergie (option CMake
+// NOISE_INVERTER_FIXED_POINT).
+//
+// Mêmes étapes que les noyaux flottants, formats :
+//   - entrée, ligne de retard et sortie en Q15 (int16) ;
+//   - coefficients du filtre en Q2.30 et états du filtre en Q31, avec
+//     accumulation sur 64 bits. Les bits perdus à la réduction en Q31 sont
+//     réinjectés à l'échantillon suivant (conservation de la fraction) :
+//     sans cela, l'erreur d'arrondi s'intègre dans le pôle en z = 1 du
+//     passe-bande et dérive en continu ;
+//   - gain (déjà inversé) en Q3.28, appliqué en sortie du filtre.
+// Les conversions d'entrée et la somme finale utilisent l'arithmétique
+// entière saturante du SIMD (SSE2, NEON) : la saturation Q15 remplace la
+// limitation à ±1 de la version flottante.
+namespace fixedpoint {
+
+constexpr int coefficientBits = 30;
+constexpr int gainBits = 28;
+
+// Contexte d'un bloc (équivalent de KernelContext)
+struct FixedKernelContext {
+    int32_t b0 = 0, b1 = 0, b2 = 0;
+    int32_t a1 = 0, a2 = 0;
+    int32_t x1 = 0, x2 = 0;
+    int32_t y1 = 0, y2 = 0;
+    int32_t residue = 0;            // Fraction conservée, en unités de 2^-61
+    int32_t negGain = 0;
+
+    int16_t* delayBuffer = nullptr;
+    size_t delayBufferSize = 0;
+    size_t writePos = 0;
+    size_t readPos = 0;
+};
+
+using FixedKernelFn = void (*)(FixedKernelContext&, float*, const float*, unsigned int);
+
+inline int32_t saturate32(int64_t value) {
+    return static_cast<int32_t>(std::max<int64_t>(INT32_MIN, std::min<int64_t>(INT32_MAX, value)));
+}
+
+inline int16_t saturate16(int64_t value) {
+    return static_cast<int16_t>(std::max<int64_t>(INT16_MIN, std::min<int64_t>(INT16_MAX, value)));
+}
+
+// Conversion d'un réel avec fracBits bits fractionnaires (saturée sur 32 bits)
+inline int32_t toFixed(float value, int fracBits) {
+    return saturate32(std::llround(static_cast<double>(value) * static_cast<double>(int64_t(1) << fracBits)));
+}
+
+// Coefficients et gain du contexte flottant
+inline void loadCoefficients(FixedKernelContext& fixed, const KernelContext& ctx) {
+    fixed.b0 = toFixed(ctx.b0, coefficientBits);
+    fixed.b1 = toFixed(ctx.b1, coefficientBits);
+    fixed.b2 = toFixed(ctx.b2, coefficientBits);
+    fixed.a1 = toFixed(ctx.a1, coefficientBits);
+    fixed.a2 = toFixed(ctx.a2, coefficientBits);
+    fixed.negGain = toFixed(ctx.negGain, gainBits);
+}
+
+// Réel -> Q15, arrondi au plus proche et saturé
+inline void floatToQ15(int16_t* out, const float* in, unsigned int n) {
+    unsigned int i = 0;
+#if defined(__SSE2__)
+    const __m128 scale = _mm_set1_ps(32768.0f);
+    const __m128 lo = _mm_set1_ps(-1.0f);
+    const __m128 hi = _mm_set1_ps(1.0f);
+    for (; i + 8 <= n; i += 8) {
+        // Borné avant la conversion : hors de l'intervalle, cvtps retourne INT32_MIN
+        __m128 a = _mm_mul_ps(_mm_min_ps(hi, _mm_max_ps(lo, _mm_loadu_ps(in + i))), scale);
+        __m128 b = _mm_mul_ps(_mm_min_ps(hi, _mm_max_ps(lo, _mm_loadu_ps(in + i + 4))), scale);
+        __m128i q = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), q);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    const float32x4_t lo = vdupq_n_f32(-1.0f);
+    const float32x4_t hi = vdupq_n_f32(1.0f);
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vmulq_n_f32(vminq_f32(hi, vmaxq_f32(lo, vld1q_f32(in + i))), 32768.0f);
+        float32x4_t b = vmulq_n_f32(vminq_f32(hi, vmaxq_f32(lo, vld1q_f32(in + i + 4))), 32768.0f);
+        int16x8_t q = vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b)));
+        vst1q_s16(out + i, q);
+    }
+#endif
+    for (; i < n; i++) {
+        float x = std::max(-1.0f, std::min(1.0f, in[i]));
+        out[i] = saturate16(std::lrint(x * 32768.0f));
+    }
+}
+
+// Somme saturée Q15 : out = a + b
+inline void addSaturate(int16_t* out, const int16_t* a, const int16_t* b, unsigned int n) {
+    unsigned int i = 0;
+#if defined(__SSE2__)
+    for (; i + 8 <= n; i += 8) {
+        __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_adds_epi16(va, vb));
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    for (; i + 8 <= n; i += 8) {
+        vst1q_s16(out + i, vqaddq_s16(vld1q_s16(a + i), vld1q_s16(b + i)));
+    }
+#endif
+    for (; i < n; i++) {
+        out[i] = saturate16(static_cast<int32_t>(a[i]) + b[i]);
+    }
+}
+
+// Étape 1 : filtre (Q31) et gain, résultat Q15 dans la ligne de retard
+template <FilterTopology Topology>
+inline void filterIntoDelay(FixedKernelContext& ctx, const int16_t* in, unsigned int nFrames) {
+    const int64_t b0 = ctx.b0, b1 = ctx.b1, b2 = ctx.b2;
+    const int64_t a1 = ctx.a1, a2 = ctx.a2;
+    const int64_t negGain = ctx.negGain;
+    int64_t x1 = ctx.x1, x2 = ctx.x2, y1 = ctx.y1, y2 = ctx.y2;
+    int64_t residue = ctx.residue;
+
+    constexpr int64_t fractionMask = (int64_t(1) << coefficientBits) - 1;
+    constexpr int gainShift = 31 + gainBits - 15;
+    constexpr int64_t roundGain = int64_t(1) << (gainShift - 1);
+
+    unsigned int done = 0;
+    while (done < nFrames) {
+        unsigned int count = static_cast<unsigned int>(
+            std::min<size_t>(nFrames - done, ctx.delayBufferSize - ctx.writePos));
+        int16_t* dst = ctx.delayBuffer + ctx.writePos;
+        const int16_t* x = in + done;
+        for (unsigned int i = 0; i < count; i++) {
+            const int64_t xi = static_cast<int64_t>(x[i]) * 65536;  // Q15 -> Q31
+            int64_t acc;
+            if constexpr (Topology == FilterTopology::ONE_POLE_LOWPASS) {
+                acc = b0 * xi - a1 * y1;
+            } else if constexpr (Topology == FilterTopology::ONE_POLE_HIGHPASS) {
+                acc = b0 * xi + b1 * x1 - a1 * y1;
+                x1 = xi;
+            } else {
+                acc = b0 * xi + b2 * x2 - a2 * y2 - a1 * y1;
+                x2 = x1;
+                x1 = xi;
+                y2 = y1;
+            }
+            acc += residue;
+            residue = acc & fractionMask;
+            int64_t y = saturate32(acc >> coefficientBits);
+            y1 = y;
+            dst[i] = saturate16((y * negGain + roundGain) >> gainShift);
+        }
+        done += count;
+        ctx.writePos += count;
+        if (ctx.writePos == ctx.delayBufferSize) {
+            ctx.writePos = 0;
+        }
+    }
+
+    ctx.x1 = static_cast<int32_t>(x1);
+    ctx.x2 = static_cast<int32_t>(x2);
+    ctx.y1 = static_cast<int32_t>(y1);
+    ctx.y2 = static_cast<int32_t>(y2);
+    ctx.residue = static_cast<int32_t>(residue);
+}
+
+// Étape 2 : somme saturée avec le signal retardé
+inline void mixFromDelay(FixedKernelContext& ctx, int16_t* out, const int16_t* in, unsigned int nFrames) {
+    unsigned int done = 0;
+    while (done < nFrames) {
+        unsigned int count = static_cast<unsigned int>(
+            std::min<size_t>(nFrames - done, ctx.delayBufferSize - ctx.readPos));
+        addSaturate(out + done, in + done, ctx.delayBuffer + ctx.readPos, count);
+        done += count;
+        ctx.readPos += count;
+        if (ctx.readPos == ctx.delayBufferSize) {
+            ctx.readPos = 0;
+        }
+    }
+}
+
+// Sous-blocs traités sur la pile (entrée et sortie Q15)
+constexpr unsigned int chunkFrames = 256;
+
+// Traite un bloc complet (même contrainte de taille que kernels::processBlock)
+template <FilterTopology Topology, unsigned int OutChannels>
+void processBlock(FixedKernelContext& ctx, float* out, const float* in, unsigned int nFrames) {
+    alignas(16) int16_t inQ15[chunkFrames];
+    alignas(16) int16_t outQ15[chunkFrames];
+    for (unsigned int done = 0; done < nFrames; done += chunkFrames) {
+        unsigned int count = std::min(chunkFrames, nFrames - done);
+        floatToQ15(inQ15, in + done, count);
+        filterIntoDelay<Topology>(ctx, inQ15, count);
+        mixFromDelay(ctx, outQ15, inQ15, count);
+
+        float* dst = out + static_cast<size_t>(done) * OutChannels;
+        for (unsigned int i = 0; i < count; i++) {
+            float value = outQ15[i] * (1.0f / 32768.0f);
+            for (unsigned int c = 0; c < OutChannels; c++) {
+                dst[i * OutChannels + c] = value;
+            }
+        }
+    }
+}
+
+// Instanciation correspondant à la configuration (1 ou 2 canaux)
+inline FixedKernelFn selectKernel(FilterTopology topology, unsigned int outChannels) {
+    using T = FilterTopology;
+    static const FixedKernelFn table[] = {
+        &processBlock<T::ONE_POLE_LOWPASS, 1>, &processBlock<T::ONE_POLE_LOWPASS, 2>,
+        &processBlock<T::ONE_POLE_HIGHPASS, 1>, &processBlock<T::ONE_POLE_HIGHPASS, 2>,
+        &processBlock<T::BIQUAD_BANDPASS, 1>, &processBlock<T::BIQUAD_BANDPASS, 2>
+    };
+    return table[static_cast<size_t>(topology) * 2 + ((outChannels >= 2) ? 1 : 0)];
+}
+
+} // namespace fixedpoint
@@ -0,0 +1,386 @@
+#include "HybridController.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+constexpr unsigned int lanes = 8;
+
+// Produit scalaire avec accumulateurs par voie (vectorisable sans -ffast-math)
+inline float dot(const float* __restrict a, const float* __restrict b, unsigned int n) {
+    float sums[lanes] = {};
+    for (unsigned int j = 0; j < n; j += lanes) {
+        for (unsigned int l = 0; l < lanes; l++) {
+            sums[l] += a[j + l] * b[j + l];
+        }
+    }
+    float total = 0.0f;
+    for (unsigned int l = 0; l < lanes; l++) {
+        total += sums[l];
+    }
+    return total;
+}
+
+// Historique à double écriture : la fenêtre [pos, pos + length) contient
+// les échantillons du plus récent au plus ancien, sans modulo
+inline void pushHistory(std::vector<float>& history, size_t& pos, size_t length, float value) {
+    pos = (pos == 0) ? length - 1 : pos - 1;
+    history[pos] = value;
+    history[pos + length] = value;
+}
+
+inline unsigned int roundUpToLanes(unsigned int n) {
+    return (n + lanes - 1) / lanes * lanes;
+}
+
+// Lissage des puissances par bloc (surveillance)
+constexpr float blockSmoothing = 0.1f;
+
+// Remontée du gain de boucle par bloc stable
+constexpr float loopGainRecovery = 0.01f;
+
+// Plus petit pas relatif après des divergences, et durée de stabilité
+// (en trames) avant de le doubler à nouveau
+constexpr float minStepScale = 1.0f / 64.0f;
+constexpr unsigned int stepRecoveryFrames = 480000;
+
+// Attente maximale d'une copie des poids pendant l'adaptation
+constexpr auto snapshotTimeout = std::chrono::milliseconds(100);
+
+} // namespace
+
+HybridController::HybridController() : HybridController(Settings()) {}
+
+HybridController::HybridController(const Settings& settings) : settings(settings) {
+    this->settings.feedforwardTaps = roundUpToLanes(std::max(settings.feedforwardTaps, lanes));
+    this->settings.feedbackTaps = roundUpToLanes(std::max(settings.feedbackTaps, lanes));
+    this->settings.secondaryTaps = roundUpToLanes(std::max(settings.secondaryTaps, lanes));
+    prepare(std::vector<float>(), 1, std::vector<float>());
+}
+
+HybridController::~HybridController() {
+    stopAdaptation();
+}
+
+void HybridController::prepare(const std::vector<float>& secondaryPath, unsigned int latencySamples,
+                               const std::vector<float>& initialWeights) {
+    const unsigned int ffTaps = settings.feedforwardTaps;
+    const unsigned int fbTaps = settings.feedbackTaps;
+    const unsigned int sTaps = settings.secondaryTaps;
+
+    // Modèle Ŝ : retard pur (taps initiaux négligeables) puis réponse utile
+    secondary.assign(sTaps, 0.0f);
+    if (secondaryPath.empty()) {
+        secondaryDelay = std::max(1u, latencySamples);
+        secondary[0] = 1.0f;
+    } else {
+        float peak = 0.0f;
+        for (float tap : secondaryPath) {
+            peak = std::max(peak, std::fabs(tap));
+        }
+        size_t first = 0;
+        while (first + 1 < secondaryPath.size() && std::fabs(secondaryPath[first]) < 0.05f * peak) {
+            first++;
+        }
+        secondaryDelay = std::max<unsigned int>(1, static_cast<unsigned int>(first));
+        for (unsigned int j = 0; j < sTaps && first + j < secondaryPath.size(); j++) {
+            secondary[j] = secondaryPath[first + j];
+        }
+    }
+
+    // Historiques à double écriture
+    const size_t span = secondaryDelay + sTaps;
+    referenceHistory.assign(2 * ffTaps, 0.0f);
+    disturbanceHistory.assign(2 * fbTaps, 0.0f);
+    outputHistory.assign(2 * span, 0.0f);
+    rawReference.assign(2 * span, 0.0f);
+    rawDisturbance.assign(2 * span, 0.0f);
+    filteredReference.assign(2 * ffTaps, 0.0f);
+    filteredDisturbance.assign(2 * fbTaps, 0.0f);
+    referencePos = disturbancePos = outputPos = 0;
+    rawPos = filteredReferencePos = filteredDisturbancePos = 0;
+
+    // Poids initiaux (session précédente) ou nuls
+    weights.assign(ffTaps + fbTaps, 0.0f);
+    if (initialWeights.size() == weights.size()) {
+        weights = initialWeights;
+    }
+    published[0] = weights;
+    published[1] = weights;
+    publishedIndex = 0;
+    publishPending = false;
+    activeIndex = 0;
+
+    loopGain = 1.0f;
+    errorPower = 0.0f;
+    disturbancePower = 0.0f;
+    stepScale = 1.0f;
+    framesSincePublish = 0;
+
+    frames.clear();
+    divergenceDetected = false;
+    statusLoopGain = 1.0f;
+    statusAttenuation = 0.0f;
+    backoffCount = 0;
+    droppedFrames = 0;
+}
+
+void HybridController::startAdaptation() {
+    if (adapting.exchange(true)) {
+        return;
+    }
+    worker = std::thread(&HybridController::adaptationThread, this);
+}
+
+void HybridController::stopAdaptation() {
+    adapting = false;
+    if (worker.joinable()) {
+        worker.join();
+    }
+}
+
+std::vector<float> HybridController::getWeights() const {
+    std::unique_lock<std::mutex> lock(snapshotMutex);
+    if (!adapting.load(std::memory_order_acquire)) {
+        return weights;
+    }
+    snapshotTaken = false;
+    snapshotWanted.store(true, std::memory_order_release);
+    if (!snapshotReady.wait_for(lock, snapshotTimeout, [this] { return snapshotTaken; })) {
+        return std::vector<float>();
+    }
+    return snapshot;
+}
+
+std::vector<float> HybridController::getSecondaryPath() const {
+    std::vector<float> path(secondaryDelay, 0.0f);
+    path.insert(path.end(), secondary.begin(), secondary.end());
+    while (path.size() > secondaryDelay + 1 && path.back() == 0.0f) {
+        path.pop_back();
+    }
+    return path;
+}
+
+HybridController::Status HybridController::getStatus() const {
+    return {statusLoopGain.load(std::memory_order_relaxed),
+            statusAttenuation.load(std::memory_order_relaxed),
+            backoffCount.load(std::memory_order_relaxed),
+            droppedFrames.load(std::memory_order_relaxed)};
+}
+
+void HybridController::process(float* output, const float* input, unsigned int nFrames,
+                               unsigned int outChannels) {
+    // Nouveaux poids publiés par le thread d'adaptation
+    if (publishPending.load(std::memory_order_acquire)) {
+        activeIndex = publishedIndex.load(std::memory_order_relaxed);
+        publishPending.store(false, std::memory_order_release);
+    }
+
+    const unsigned int ffTaps = settings.feedforwardTaps;
+    const unsigned int fbTaps = settings.feedbackTaps;
+    const unsigned int sTaps = settings.secondaryTaps;
+    const size_t span = secondaryDelay + sTaps;
+    float* ff = published[activeIndex].data();
+    float* fb = ff + ffTaps;
+    const float limit = settings.outputLimit;
+
+    float blockError = 0.0f;
+    float blockDisturbance = 0.0f;
+    bool finite = true;
+    unsigned int dropped = 0;
+
+    for (unsigned int n = 0; n < nFrames; n++) {
+        float x = input[2 * n];
+        float e = input[2 * n + 1];
+
+        // Perturbation estimée : erreur moins la contribution prédite de la sortie
+        float predicted = dot(secondary.data(), &outputHistory[outputPos + secondaryDelay - 1], sTaps);
+        float d = e - predicted;
+
+        pushHistory(referenceHistory, referencePos, ffTaps, x);
+        pushHistory(disturbanceHistory, disturbancePos, fbTaps, d);
+
+        // Anticipation + rétroaction, échantillon par échantillon
+        float y = dot(ff, &referenceHistory[referencePos], ffTaps)
+                + dot(fb, &disturbanceHistory[disturbancePos], fbTaps);
+        y *= loopGain;
+        if (!std::isfinite(y)) {
+            finite = false;
+            y = 0.0f;
+        }
+        y = std::clamp(y, -limit, limit);
+        pushHistory(outputHistory, outputPos, span, y);
+
+        for (unsigned int ch = 0; ch < outChannels; ch++) {
+            output[n * outChannels + ch] = y;
+        }
+
+        blockError += e * e;
+        blockDisturbance += d * d;
+        if (!frames.push({x, d, e})) {
+            dropped++;
+        }
+    }
+
+    if (dropped > 0) {
+        droppedFrames.fetch_add(dropped, std::memory_order_relaxed);
+    }
+    if (nFrames == 0) {
+        return;
+    }
+
+    // Surveillance de stabilité
+    errorPower += blockSmoothing * (blockError / nFrames - errorPower);
+    disturbancePower += blockSmoothing * (blockDisturbance / nFrames - disturbancePower);
+
+    bool diverging = !finite ||
+        (errorPower > settings.divergenceRatio * disturbancePower && errorPower > 1e-10f);
+    if (diverging) {
+        // Repli : gain de boucle divisé par deux, poids actifs annulés
+        // immédiatement, adaptation relancée de zéro par le thread de travail
+        loopGain *= 0.5f;
+        std::fill(published[activeIndex].begin(), published[activeIndex].end(), 0.0f);
+        errorPower = disturbancePower;
+        divergenceDetected.store(true, std::memory_order_release);
+        backoffCount.fetch_add(1, std::memory_order_relaxed);
+    } else if (errorPower <= disturbancePower) {
+        loopGain = std::min(1.0f, loopGain + loopGainRecovery);
+    }
+
+    statusLoopGain.store(loopGain, std::memory_order_relaxed);
+    if (disturbancePower > 0.0f && errorPower > 0.0f) {
+        statusAttenuation.store(10.0f * std::log10(errorPower / disturbancePower), std::memory_order_relaxed);
+    }
+}
+
+void HybridController::adaptationThread() {
+    Frame frame;
+    unsigned int stableFrames = 0;
+    trace::setThreadName("adaptation");
+
+    while (adapting.load(std::memory_order_relaxed)) {
+        serveSnapshot();
+
+        bool received = false;
+        for (;;) {
+            // Divergence signalée par le thread audio (à chaque trame : elle
+            // peut survenir pendant la vidange de la file). Les trames en
+            // attente proviennent des poids fautifs : les oublier, sans
+            // publier avant d'en avoir adapté de nouvelles.
+            if (divergenceDetected.exchange(false, std::memory_order_acq_rel)) {
+                resetAdaptation();
+                stableFrames = 0;
+                framesSincePublish = 0;
+                while (frames.pop(frame)) {
+                }
+            }
+            if (!frames.pop(frame)) {
+                break;
+            }
+            if (!received) {
+                trace::begin("adaptation");
+            }
+            received = true;
+            adaptFrame(frame);
+
+            if (++framesSincePublish >= settings.publishInterval) {
+                publishWeights();
+            }
+            if (++stableFrames >= stepRecoveryFrames) {
+                stepScale = std::min(1.0f, stepScale * 2.0f);
+                stableFrames = 0;
+            }
+        }
+        if (received) {
+            trace::end("adaptation");
+        }
+
+        if (!received) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void HybridController::adaptFrame(const Frame& frame) {
+    const unsigned int ffTaps = settings.feedforwardTaps;
+    const unsigned int fbTaps = settings.feedbackTaps;
+    const unsigned int sTaps = settings.secondaryTaps;
+    const size_t span = secondaryDelay + sTaps;
+
+    // Références filtrées par Ŝ (retard pur compris)
+    rawPos = (rawPos == 0) ? span - 1 : rawPos - 1;
+    rawReference[rawPos] = rawReference[rawPos + span] = frame.reference;
+    rawDisturbance[rawPos] = rawDisturbance[rawPos + span] = frame.disturbance;
+    float xf = dot(secondary.data(), &rawReference[rawPos + secondaryDelay], sTaps);
+    float df = dot(secondary.data(), &rawDisturbance[rawPos + secondaryDelay], sTaps);
+    pushHistory(filteredReference, filteredReferencePos, ffTaps, xf);
+    pushHistory(filteredDisturbance, filteredDisturbancePos, fbTaps, df);
+
+    const float* __restrict xh = &filteredReference[filteredReferencePos];
+    const float* __restrict dh = &filteredDisturbance[filteredDisturbancePos];
+
+    // FxLMS normalisé par l'énergie des fenêtres : w ← λ·w - μ·e·x' / ‖x'‖².
+    // Le pas est réduit en proportion du retard de la boucle (chemin
+    // secondaire et publication) : un LMS retardé de D échantillons n'est
+    // stable que pour μ·λmax de l'ordre de 1/D.
+    const float leak = settings.leakage;
+    const float delay = static_cast<float>(secondaryDelay + settings.publishInterval);
+    float muFF = stepScale * settings.feedforwardStep * ffTaps / (ffTaps + delay)
+               / (dot(xh, xh, ffTaps) + 1e-6f);
+    float muFB = stepScale * settings.feedbackStep * fbTaps / (fbTaps + delay)
+               / (dot(dh, dh, fbTaps) + 1e-6f);
+    float gradFF = muFF * frame.error;
+    float gradFB = muFB * frame.error;
+
+    float* __restrict w = weights.data();
+    for (unsigned int k = 0; k < ffTaps; k++) {
+        w[k] = leak * w[k] - gradFF * xh[k];
+    }
+    float* __restrict c = weights.data() + ffTaps;
+    for (unsigned int k = 0; k < fbTaps; k++) {
+        c[k] = leak * c[k] - gradFB * dh[k];
+    }
+}
+
+void HybridController::publishWeights() {
+    // Le tampon précédent n'a pas encore été repris par le thread audio, ou
+    // une divergence vient d'être signalée (traitée à la trame suivante)
+    if (publishPending.load(std::memory_order_acquire) ||
+        divergenceDetected.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // Poids non finis : repartir de zéro plutôt que de publier
+    float norm = 0.0f;
+    for (float w : weights) {
+        norm += w * w;
+    }
+    if (!std::isfinite(norm)) {
+        resetAdaptation();
+    }
+
+    int next = 1 - publishedIndex.load(std::memory_order_relaxed);
+    std::copy(weights.begin(), weights.end(), published[next].begin());
+    publishedIndex.store(next, std::memory_order_relaxed);
+    publishPending.store(true, std::memory_order_release);
+    framesSincePublish = 0;
+    NI_TRACE_INSTANT("poids publiés", stepScale);
+}
+
+// Copie des poids pour getWeights (thread d'adaptation)
+void HybridController::serveSnapshot() {
+    if (!snapshotWanted.exchange(false, std::memory_order_acq_rel)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    snapshot = weights;
+    snapshotTaken = true;
+    snapshotReady.notify_all();
+}
+
+void HybridController::resetAdaptation() {
+    std::fill(weights.begin(), weights.end(), 0.0f);
+    stepScale = std::max(minStepScale, stepScale * 0.5f);
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "SpscRing.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Contrôle actif hybride : anticipation (feedforward) et rétroaction (feedback).
+//
+// Entrée stéréo entrelacée : canal 0 = micro de référence x, canal 1 = micro
+// d'erreur e. Structure IMC : la perturbation au micro d'erreur est estimée
+// par d̂ = e - Ŝ·y, où Ŝ modélise le chemin secondaire (sortie -> micro
+// d'erreur). La sortie est y = W·x + C·d̂, avec W (anticipation) et C
+// (rétroaction, court) deux filtres FIR.
+//
+// Le thread audio calcule y échantillon par échantillon : la rétroaction
+// réagit donc avec la seule latence du chemin secondaire. L'adaptation
+// (FxLMS normalisé sur Ŝ·x et Ŝ·d̂) tourne sur un thread de travail, alimenté
+// par une file sans verrou ; les poids sont publiés en double tampon.
+//
+// Surveillance de stabilité : si la puissance d'erreur dépasse durablement
+// celle de la perturbation estimée (la boucle aggrave le bruit), ou si la
+// sortie n'est plus finie, le gain de boucle est divisé par deux et
+// l'adaptation repart de zéro avec un pas réduit. Le gain remonte
+// progressivement tant que la boucle atténue.
+class HybridController {
+public:
+    struct Settings {
+        unsigned int feedforwardTaps = 64;   // Multiple de 8
+        unsigned int feedbackTaps = 16;      // Multiple de 8
+        unsigned int secondaryTaps = 32;     // Taille max du modèle Ŝ (après retard pur)
+        float feedforwardStep = 0.1f;        // Pas NLMS (avant compensation du retard)
+        float feedbackStep = 0.02f;
+        float leakage = 0.99999f;
+        float divergenceRatio = 4.0f;        // Puissance e / d̂ tolérée (+6 dB)
+        float outputLimit = 1.0f;
+        unsigned int publishInterval = 32;   // Échantillons entre deux publications
+    };
+
+    struct Status {
+        float loopGain;
+        float attenuationDb;                 // 10·log10(Pe / Pd̂), négatif si la boucle atténue
+        unsigned int backoffs;
+        unsigned int droppedFrames;          // Trames non adaptées (file pleine)
+    };
+
+    HybridController();
+    explicit HybridController(const Settings& settings);
+    ~HybridController();
+
+    // Hors du thread audio, adaptation arrêtée. secondaryPath : réponse
+    // impulsionnelle mesurée (vide : retard pur de latencySamples).
+    // initialWeights : poids W puis C d'une session précédente (ignorés si
+    // la taille ne correspond pas).
+    void prepare(const std::vector<float>& secondaryPath, unsigned int latencySamples,
+                 const std::vector<float>& initialWeights);
+
+    // Thread d'adaptation
+    void startAdaptation();
+    void stopAdaptation();
+
+    // Thread audio : input entrelacé à deux canaux, sortie sur outChannels
+    void process(float* output, const float* input, unsigned int nFrames, unsigned int outChannels);
+
+    // Poids courants (W puis C). Adaptation en cours : copie faite par le
+    // thread d'adaptation entre deux trames (vide s'il ne répond pas)
+    std::vector<float> getWeights() const;
+    unsigned int weightCount() const { return settings.feedforwardTaps + settings.feedbackTaps; }
+
+    // Modèle Ŝ utilisé (retard pur puis réponse), sous la forme acceptée par prepare()
+    std::vector<float> getSecondaryPath() const;
+
+    Status getStatus() const;
+
+private:
+    // Trame transmise au thread d'adaptation
+    struct Frame {
+        float reference;
+        float disturbance;
+        float error;
+    };
+
+    // Thread d'adaptation FxLMS
+    void adaptationThread();
+    void adaptFrame(const Frame& frame);
+    void publishWeights();
+    void resetAdaptation();
+    void serveSnapshot();
+
+    Settings settings;
+
+    // Modèle du chemin secondaire : retard pur puis FIR (taille multiple de 8)
+    unsigned int secondaryDelay = 1;
+    std::vector<float> secondary;
+
+    // Poids publiés (double tampon : W puis C)
+    std::vector<float> published[2];
+    std::atomic<int> publishedIndex{0};
+    std::atomic<bool> publishPending{false};
+
+    // État du thread audio
+    int activeIndex = 0;
+    std::vector<float> referenceHistory;    // 2 × feedforwardTaps (double écriture)
+    std::vector<float> disturbanceHistory;  // 2 × feedbackTaps
+    std::vector<float> outputHistory;       // Puissance de deux ≥ retard + taps
+    size_t referencePos = 0;
+    size_t disturbancePos = 0;
+    size_t outputPos = 0;
+    float loopGain = 1.0f;
+    float errorPower = 0.0f;
+    float disturbancePower = 0.0f;
+
+    // État du thread d'adaptation
+    std::vector<float> weights;             // W puis C (copie maîtresse)
+    std::vector<float> rawReference;        // x puis d̂ bruts, pour le filtrage Ŝ
+    std::vector<float> rawDisturbance;
+    std::vector<float> filteredReference;   // Ŝ·x (2 × feedforwardTaps)
+    std::vector<float> filteredDisturbance; // Ŝ·d̂ (2 × feedbackTaps)
+    size_t rawPos = 0;
+    size_t filteredReferencePos = 0;
+    size_t filteredDisturbancePos = 0;
+    float stepScale = 1.0f;
+    unsigned int framesSincePublish = 0;
+
+    // Communication entre les threads
+    SpscRing<Frame> frames{1 << 15};
+    std::atomic<bool> divergenceDetected{false};
+    std::atomic<bool> adapting{false};
+    std::atomic<float> statusLoopGain{1.0f};
+    std::atomic<float> statusAttenuation{0.0f};
+    std::atomic<unsigned int> backoffCount{0};
+    std::atomic<unsigned int> droppedFrames{0};
+    std::thread worker;
+
+    // Copie des poids demandée pendant l'adaptation (getWeights)
+    mutable std::mutex snapshotMutex;
+    mutable std::condition_variable snapshotReady;
+    mutable std::atomic<bool> snapshotWanted{false};
+    mutable bool snapshotTaken = false;
+    std::vector<float> snapshot;
+};
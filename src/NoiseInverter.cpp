@@ -1,5 +1,12 @@
 #include "NoiseInverter.h"
+#include "RealtimeAudit.h"
+#include "NullBackend.h"
+#include "BufferSizeController.h"
+#include "ProfileStore.h"
+#include "FixedPointKernels.h"
+#include "Trace.h"
 #include <chrono>
+#include <random>
 #include <algorithm>
 #include <cstring>
 #include <cmath> // pour M_PI
@@ -9,22 +16,70 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-// Constructeur
-NoiseInverter::NoiseInverter() {
-    // Initialiser le tampon de délai (50ms max)
-    delayBufferSize = static_cast<size_t>(sampleRate * 0.050);
-    delayBuffer.resize(delayBufferSize, 0.0f);
-    
-    // Initialiser les buffers de visualisation
-    vizData.inputSignal.resize(vizBufferSize, 0.0f);
-    vizData.outputSignal.resize(vizBufferSize, 0.0f);
+// Horodatage des callbacks pour la surveillance du flux
+static inline int64_t steadyNanoseconds(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+// Constructeur (sans périphérique si aucun backend n'est fourni : le moteur
+// ne dépend pas de RtAudio, que l'application fournit)
+NoiseInverter::NoiseInverter(std::unique_ptr<AudioBackend> audioBackend)
+    : backend(audioBackend ? std::move(audioBackend) : std::make_unique<NullBackend>()) {
+    allocateBuffers();
     
     // Calculer les coefficients du filtre
     calculateFilterCoefficients();
+}
+
+// Dispose les tampons dépendant de la fréquence d'échantillonnage dans
+// l'arène (flux arrêté). L'état lu à chaque bloc vient en premier ; la
+// visualisation, facultative, en dernier.
+void NoiseInverter::allocateBuffers() {
+    // Tampon de délai (50ms max, doublé pour que les noyaux puissent
+    // filtrer un bloc entier avant de lire le signal retardé)
+    delayBufferSize = 2 * static_cast<size_t>(sampleRate * 0.050);
+    
+    std::lock_guard<std::mutex> lock(vizData.mutex);
+    arena.reset();
+    size_t referenceOffset = arena.reserve<float>(referenceChunkFrames);
+#ifdef NOISE_INVERTER_FIXED_POINT
+    size_t delayOffset = arena.reserve<int16_t>(delayBufferSize);
+#else
+    size_t delayOffset = arena.reserve<float>(delayBufferSize);
+#endif
+    size_t vizInputOffset = arena.reserve<float>(vizBufferSize);
+    size_t vizOutputOffset = arena.reserve<float>(vizBufferSize);
+    
+    // Nouvelle zone mise à zéro, verrouillée si la précédente l'était
+    bool wasLocked = arena.isLocked();
+    if (!arena.allocate()) {
+        throw std::bad_alloc();
+    }
+    if (wasLocked) {
+        arena.lock();
+    }
     
-    std::cout << "NoiseInverter initialisé - Optimisé pour Focusrite Firewire" << std::endl;
-    std::cout << "Taux d'échantillonnage: " << sampleRate << " Hz" << std::endl;
-    std::cout << "Taille du tampon: " << bufferFrames << " échantillons" << std::endl;
+    referenceScratch = ArenaSpan<float>(arena.at<float>(referenceOffset), referenceChunkFrames);
+#ifdef NOISE_INVERTER_FIXED_POINT
+    delayBufferQ15 = ArenaSpan<int16_t>(arena.at<int16_t>(delayOffset), delayBufferSize);
+#else
+    delayBuffer = ArenaSpan<float>(arena.at<float>(delayOffset), delayBufferSize);
+#endif
+    delayBufferPos = 0;
+    vizData.inputSignal = ArenaSpan<float>(arena.at<float>(vizInputOffset), vizBufferSize);
+    vizData.outputSignal = ArenaSpan<float>(arena.at<float>(vizOutputOffset), vizBufferSize);
+    
+    // Oscillateurs du mode tonal
+    tonal.prepare(sampleRate);
+}
+
+// Verrouille l'état du moteur en mémoire (au démarrage)
+void NoiseInverter::lockEngineState() {
+    if (!arena.lock() && !memoryLockWarned) {
+        std::cerr << "Verrouillage en mémoire refusé (RLIMIT_MEMLOCK) : état du moteur ("
+                  << arena.size() / 1024 << " Kio) non verrouillé" << std::endl;
+        memoryLockWarned = true;
+    }
 }
 
 // Destructeur
@@ -32,161 +87,383 @@ NoiseInverter::~NoiseInverter() {
     stop();
 }
 
-// Liste les périphériques audio disponibles
-std::vector<NoiseInverter::AudioDevice> NoiseInverter::listDevices() {
-    std::vector<AudioDevice> deviceList;
+// Remplace le backend audio (flux arrêté uniquement)
+bool NoiseInverter::setBackend(std::unique_ptr<AudioBackend> newBackend) {
+    if (running || !newBackend) {
+        return false;
+    }
+    backend = std::move(newBackend);
+    return true;
+}
+
+// Ouvre le magasin de profils et le cache des périphériques
+bool NoiseInverter::openProfileStore(const std::string& directory) {
+    return profileStore.open(directory);
+}
+
+// Liste les périphériques audio disponibles.
+// Sans refresh, la liste en cache est retournée sans sonder les périphériques ;
+// elle est revalidée au démarrage pour les seuls périphériques choisis.
+std::vector<NoiseInverter::AudioDevice> NoiseInverter::listDevices(bool refresh) {
+    std::vector<AudioDevice> devices;
+    if (!refresh && profileStore.getCachedDevices(backend->name(), devices)) {
+        knownDevices = devices;
+        devicesFromCache = true;
+        return devices;
+    }
     
-    // Obtenir les informations sur les périphériques
-    unsigned int deviceCount = audio.getDeviceCount();
-    std::cout << "Périphériques audio disponibles: " << deviceCount << std::endl;
+    devices = backend->listDevices();
+    knownDevices = devices;
+    devicesFromCache = false;
+    if (profileStore.isOpen()) {
+        profileStore.storeDevices(backend->name(), devices);
+        profileStore.saveDevices();
+    }
+    return devices;
+}
+
+// Nom connu d'un périphérique (liste courante)
+std::string NoiseInverter::knownDeviceName(int id) const {
+    for (const AudioDevice& device : knownDevices) {
+        if (device.id == id) {
+            return device.name;
+        }
+    }
+    return std::string();
+}
+
+// Vérifie qu'un identifiant issu du cache désigne toujours le même
+// périphérique ; sinon, réénumère et retrouve le périphérique par son nom
+int NoiseInverter::revalidateDevice(int id) {
+    if (id < 0 || !devicesFromCache) {
+        return id;
+    }
     
-    for (unsigned int i = 0; i < deviceCount; i++) {
-        RtAudio::DeviceInfo info = audio.getDeviceInfo(i);
-        
-        // Supprimé la vérification de info.probed
-        {
-            // Créer une entrée pour le périphérique d'entrée
-            if (info.inputChannels > 0) {
-                AudioDevice device;
-                device.id = i;
-                device.name = info.name;
-                device.isInput = true;
-                device.isOutput = false;
-                device.isDefault = info.isDefaultInput;
-                device.maxChannels = info.inputChannels;
-                device.sampleRates = info.sampleRates;
-                
-                deviceList.push_back(device);
-                
-                std::cout << "Périphérique " << i << ": " << info.name << " (Entrée)" << std::endl;
-            }
-            
-            // Créer une entrée pour le périphérique de sortie
-            if (info.outputChannels > 0) {
-                AudioDevice device;
-                device.id = i + 1000;  // +1000 pour différencier entrée/sortie
-                device.name = info.name;
-                device.isInput = false;
-                device.isOutput = true;
-                device.isDefault = info.isDefaultOutput;
-                device.maxChannels = info.outputChannels;
-                device.sampleRates = info.sampleRates;
-                
-                deviceList.push_back(device);
-                
-                std::cout << "Périphérique " << i << ": " << info.name << " (Sortie)" << std::endl;
-            }
-            
-            // Afficher les informations détaillées
-            std::cout << "  Entrées: " << info.inputChannels 
-                      << ", Sorties: " << info.outputChannels << std::endl;
-            
-            std::cout << "  Fréquences supportées: ";
-            for (size_t j = 0; j < std::min(size_t(5), info.sampleRates.size()); j++) {
-                std::cout << info.sampleRates[j] << " ";
-            }
-            if (info.sampleRates.size() > 5) {
-                std::cout << "...";
-            }
-            std::cout << std::endl;
-            
-            // Vérifier si c'est un périphérique Focusrite
-            if (info.name.find("Focusrite") != std::string::npos ||
-                info.name.find("Saffire") != std::string::npos) {
-                std::cout << "  *** Périphérique Focusrite détecté! ***" << std::endl;
-            }
+    std::string cachedName = knownDeviceName(id);
+    if (cachedName.empty() || backend->deviceName(id) == cachedName) {
+        return id;
+    }
+    
+    std::cout << "Cache des périphériques obsolète, nouvelle énumération..." << std::endl;
+    bool isOutput = id >= 1000;
+    listDevices(true);
+    for (const AudioDevice& device : knownDevices) {
+        if (device.name == cachedName && device.isOutput == isOutput) {
+            return device.id;
         }
     }
+    return -1;  // Périphérique disparu : utiliser le périphérique par défaut
+}
+
+// Clé du profil pour le flux courant (taille de tampon configurée :
+// l'adaptation ne doit pas changer de profil)
+uint64_t NoiseInverter::currentProfileKey() const {
+    std::string inputName = streamConfig.inputDevice < 0 ? "default" : knownDeviceName(streamConfig.inputDevice);
+    std::string outputName = streamConfig.outputDevice < 0 ? "default" : knownDeviceName(streamConfig.outputDevice);
+    return ProfileStore::makeKey(backend->name(), inputName, outputName,
+                                 streamConfig.sampleRate, profileFrames,
+                                 streamConfig.inputChannels, streamConfig.outputChannels);
+}
+
+// Profil lu sur disque : un fichier corrompu ou d'une autre version ne doit
+// pas atteindre le moteur
+static bool validProfile(const CalibrationProfile& profile, unsigned int sampleRate, unsigned int weightCount) {
+    const float nyquist = 0.5f * static_cast<float>(sampleRate);
+    auto finite = [](const std::vector<float>& values) {
+        return std::all_of(values.begin(), values.end(), [](float value) { return std::isfinite(value); });
+    };
+    return std::isfinite(profile.delayMs) && profile.delayMs >= 0.0f && profile.delayMs <= 50.0f &&
+           std::isfinite(profile.gain) && profile.gain >= 0.0f && profile.gain <= 2.0f &&
+           std::isfinite(profile.lowFreq) && profile.lowFreq > 0.0f && profile.lowFreq <= nyquist &&
+           std::isfinite(profile.highFreq) && profile.highFreq > 0.0f && profile.highFreq <= nyquist &&
+           profile.filterType >= NoiseInverter::BANDPASS && profile.filterType <= NoiseInverter::HIGHPASS &&
+           profile.secondaryPath.size() <= sampleRate / 10 && finite(profile.secondaryPath) &&
+           (profile.adaptiveWeights.empty() || profile.adaptiveWeights.size() == weightCount) &&
+           finite(profile.adaptiveWeights);
+}
+
+// Applique le profil enregistré pour le flux courant, s'il existe et s'il
+// est valide (sinon les réglages courants restent en vigueur)
+bool NoiseInverter::loadProfile() {
+    const CalibrationProfile* profile = profileStore.findProfile(currentProfileKey());
+    if (!profile) {
+        return false;
+    }
+    if (!validProfile(*profile, streamConfig.sampleRate, hybrid.weightCount())) {
+        std::cerr << "Profil ignoré (" << profile->label << ") : valeurs invalides" << std::endl;
+        return false;
+    }
+    
+    setParameters(profile->delayMs, profile->gain, profile->lowFreq, profile->highFreq,
+                  static_cast<FilterType>(profile->filterType));
+    secondaryPath = profile->secondaryPath;
+    adaptiveWeights = profile->adaptiveWeights;
+    
+    std::cout << "Profil chargé (" << profile->label << "): délai = " << delayMs
+              << " ms, gain = " << gain << std::endl;
+    return true;
+}
+
+// Profil du flux courant avec les paramètres en vigueur
+CalibrationProfile NoiseInverter::currentProfile() const {
+    CalibrationProfile profile;
+    profile.label = std::string(backend->name()) + ": " +
+                    (streamConfig.inputDevice < 0 ? "default" : knownDeviceName(streamConfig.inputDevice)) + " -> " +
+                    (streamConfig.outputDevice < 0 ? "default" : knownDeviceName(streamConfig.outputDevice)) + " @" +
+                    std::to_string(streamConfig.sampleRate) + "/" + std::to_string(profileFrames);
+    profile.delayMs = delayMs;
+    profile.gain = gain;
+    profile.lowFreq = lowFreq;
+    profile.highFreq = highFreq;
+    profile.filterType = currentFilterType;
+    return profile;
+}
+
+// État hybride (modèle Ŝ et poids, copiés pendant l'adaptation) du flux
+// courant. Il dépend de la latence : seulement à la taille de tampon de la clé.
+bool NoiseInverter::captureHybridState(CalibrationProfile& profile) {
+    if (streamConfig.inputChannels < 2 || bufferFrames != profileFrames) {
+        return false;
+    }
+    std::vector<float> weights = hybrid.getWeights();
+    if (weights.size() != hybrid.weightCount()) {
+        return false;
+    }
+    profile.secondaryPath = hybrid.getSecondaryPath();
+    profile.adaptiveWeights = std::move(weights);
+    return true;
+}
+
+// Enregistre les paramètres courants comme profil du flux courant
+// (calibration uniquement ; jamais lorsque les profils sont ignorés)
+bool NoiseInverter::saveProfile() {
+    if (!profileLoading || !profileStore.isOpen()) {
+        return false;
+    }
     
-    return deviceList;
+    CalibrationProfile profile = currentProfile();
+    captureHybridState(profile);
+    profileStore.storeProfile(currentProfileKey(), profile);
+    return profileStore.saveProfiles();
+}
+
+// Met à jour l'état hybride du profil du flux courant (arrêt). Les
+// paramètres d'un profil existant et valide (calibrés) sont conservés ;
+// sinon, les paramètres en vigueur l'accompagnent.
+bool NoiseInverter::saveHybridState() {
+    if (!profileLoading || !profileStore.isOpen()) {
+        return false;
+    }
+    
+    const CalibrationProfile* stored = profileStore.findProfile(currentProfileKey());
+    bool keepStored = stored && validProfile(*stored, streamConfig.sampleRate, hybrid.weightCount());
+    CalibrationProfile profile = keepStored ? *stored : currentProfile();
+    if (!captureHybridState(profile)) {
+        return false;
+    }
+    profileStore.storeProfile(currentProfileKey(), profile);
+    return profileStore.saveProfiles();
 }
 
 // Démarre le traitement audio
 bool NoiseInverter::start(int inputDevice, int outputDevice) {
+    std::lock_guard<std::mutex> lock(streamMutex);
     if (running) {
         return true;
     }
     
-    try {
-        // Ajuster les indices
-        if (inputDevice >= 1000) {
-            inputDevice -= 1000;
+    // Les identifiants peuvent provenir du cache des périphériques
+    streamConfig = StreamConfig();
+    streamConfig.inputDevice = revalidateDevice(inputDevice);
+    streamConfig.outputDevice = revalidateDevice(outputDevice);
+    // Mono pour l'entrée ; référence + micro d'erreur en mode hybride
+    streamConfig.inputChannels = (engineMode == HYBRID) ? 2 : 1;
+    streamConfig.outputChannels = outputChannels;
+    streamConfig.sampleRate = sampleRate;
+    streamConfig.bufferFrames = bufferFrames;
+    streamConfig.streamName = "NoiseInverter";
+    
+    // Ouvrir le stream
+    std::cout << "Ouverture du stream audio (" << backend->name() << ")..." << std::endl;
+    std::cout << "  Taux d'échantillonnage: " << sampleRate << " Hz" << std::endl;
+    std::cout << "  Taille du tampon: " << bufferFrames << " échantillons" << std::endl;
+    
+    // Profil enregistré pour cette configuration (appliqué avant le premier bloc)
+    bool profileLoaded = profileLoading && loadProfile();
+    
+    if (!openStream()) {
+        // Le cache a pu masquer un changement de périphériques : réessayer une fois
+        if (!devicesFromCache) {
+            return false;
         }
-        
-        if (outputDevice >= 1000) {
-            outputDevice -= 1000;
+        listDevices(true);
+        streamConfig.inputDevice = -1;
+        streamConfig.outputDevice = -1;
+        std::cout << "Nouvel essai avec les périphériques par défaut..." << std::endl;
+        if (!openStream()) {
+            return false;
         }
-        
-        RtAudio::StreamParameters inParams;
-        inParams.deviceId = inputDevice;
-        inParams.nChannels = 1;  // Mono pour l'entrée
-        inParams.firstChannel = 0;
-        
-        RtAudio::StreamParameters outParams;
-        outParams.deviceId = outputDevice;
-        outParams.nChannels = 2;  // Stéréo pour la sortie
-        outParams.firstChannel = 0;
-        
-        RtAudio::StreamOptions options;
-        options.flags = RTAUDIO_MINIMIZE_LATENCY | RTAUDIO_SCHEDULE_REALTIME;
-        options.numberOfBuffers = 2;  // Minimiser les buffers
-        options.priority = 85;  // Haute priorité
-        options.streamName = "NoiseInverter";
-        
-        // Ouvrir le stream
-        std::cout << "Ouverture du stream audio..." << std::endl;
-        std::cout << "  Entrée: " << inputDevice << ", Sortie: " << outputDevice << std::endl;
-        std::cout << "  Taux d'échantillonnage: " << sampleRate << " Hz" << std::endl;
-        std::cout << "  Taille du tampon: " << bufferFrames << " échantillons" << std::endl;
-        
-        audio.openStream(&outParams, &inParams, RTAUDIO_FLOAT32,
-                       sampleRate, &bufferFrames, &audioCallback,
-                       this, &options);
-        
-        // Démarrer le stream
-        audio.startStream();
-        
-        // Estimation simple de la latence basée sur la taille du buffer
-        measuredLatency = (bufferFrames * 1000.0f) / sampleRate * 2.0f;
-        
-        std::cout << "Stream audio démarré avec succès!" << std::endl;
-        std::cout << "Taille du tampon effective: " << bufferFrames << " échantillons" << std::endl;
-        std::cout << "Latence estimée: " << measuredLatency << " ms" << std::endl;
-        
-        running = true;
-        
-        // Démarrer un thread pour surveiller la charge CPU
-        std::thread monitorThread(&NoiseInverter::cpuMonitorThread, this);
-        monitorThread.detach();
-        
-        return true;
     }
-    catch (const std::exception& e) {
-        std::cerr << "Erreur: " << e.what() << std::endl;
+    
+    std::cout << "Stream audio démarré avec succès!" << std::endl;
+    std::cout << "Taille du tampon effective: " << bufferFrames << " échantillons" << std::endl;
+    std::cout << "Latence estimée: " << measuredLatency << " ms" << std::endl;
+    if (!profileLoaded && profileLoading && profileStore.isOpen()) {
+        std::cout << "Aucun profil enregistré pour cette configuration" << std::endl;
+    }
+    
+    bufferController.reset(bufferFrames);
+    callbackLoadMax = 0.0f;
+    xrunCount = 0;
+    
+    // Surveillance de la charge et de la santé du flux (jointe par stop)
+    {
+        std::lock_guard<std::mutex> monitorLock(monitorMutex);
+        monitorStop = false;
+    }
+    monitor = std::thread(&NoiseInverter::monitorThread, this);
+    
+    return true;
+}
+
+// Ouvre et démarre le flux avec streamConfig (streamMutex verrouillé)
+bool NoiseInverter::openStream() {
+    if (!backend->open(streamConfig, &audioCallback, this)) {
+        std::cerr << "Erreur: impossible d'ouvrir le stream audio" << std::endl;
+        return false;
+    }
+    
+    // Le backend peut imposer sa fréquence (fichier) et sa taille de tampon
+    bufferFrames = streamConfig.bufferFrames;
+    if (streamConfig.sampleRate != sampleRate) {
+        sampleRate = streamConfig.sampleRate;
+        allocateBuffers();
+        calculateFilterCoefficients();
+    }
+    
+    // Estimation simple de la latence basée sur la taille du buffer
+    measuredLatency = (bufferFrames * 1000.0f) / sampleRate * 2.0f;
+    measuredLatency += (backend->extraLatencyFrames() * 1000.0f) / sampleRate;
+    
+    // Contrôleur hybride (micro d'erreur sur l'entrée 2)
+    if (streamConfig.inputChannels >= 2) {
+        hybrid.stopAdaptation();
+        hybrid.prepare(secondaryPath, 2 * bufferFrames + backend->extraLatencyFrames(), adaptiveWeights);
+        hybrid.startAdaptation();
+    }
+    
+    // État du moteur résident avant le premier bloc
+    lockEngineState();
+    
+    // Le thread de traitement peut démarrer dès startStream : marquer avant.
+    // L'ouverture tient lieu de premier battement pour la surveillance.
+    running = true;
+    lastCallbackNs.store(steadyNanoseconds(std::chrono::steady_clock::now()), std::memory_order_relaxed);
+    
+    // Démarrer le stream
+    if (!backend->start()) {
+        running = false;
+        backend->close();
+        hybrid.stopAdaptation();
+        std::cerr << "Erreur: impossible de démarrer le stream audio" << std::endl;
         return false;
     }
+    
+    return true;
+}
+
+// Rouvre le flux avec une nouvelle taille de tampon.
+// La sortie est atténuée avant l'arrêt puis rétablie progressivement ;
+// l'état du moteur (ligne de retard, filtre, paramètres) est conservé.
+bool NoiseInverter::restartStream(unsigned int newFrames) {
+    std::lock_guard<std::mutex> lock(streamMutex);
+    if (!running) {
+        return false;
+    }
+    
+    // Fondu de sortie, attendu au plus quelques périodes
+    fadeOutComplete = false;
+    fadeRequest = FADE_OUT;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (!fadeOutComplete && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    
+    unsigned int previousFrames = bufferFrames;
+    backend->stop();
+    backend->close();
+    
+    // La latence change : le modèle du chemin secondaire et les poids
+    // hybrides ne correspondent plus
+    secondaryPath.clear();
+    adaptiveWeights.clear();
+    
+    // Le callback reprendra en fondu d'entrée
+    fadeRequest = FADE_IN;
+    streamConfig.bufferFrames = newFrames;
+    if (openStream()) {
+        return true;
+    }
+    
+    // Échec : revenir à la taille précédente
+    std::cerr << "Réouverture avec " << newFrames << " échantillons impossible, retour à "
+              << previousFrames << std::endl;
+    fadeRequest = FADE_IN;
+    streamConfig.bufferFrames = previousFrames;
+    return openStream();
 }
 
 // Arrête le traitement audio
 void NoiseInverter::stop() {
+    // La surveillance peut rouvrir le flux : l'arrêter avant de le fermer
+    stopMonitor();
+    
+    std::lock_guard<std::mutex> lock(streamMutex);
     if (running) {
-        try {
-            running = false;
-            if (audio.isStreamRunning()) {
-                audio.stopStream();
-            }
-            if (audio.isStreamOpen()) {
-                audio.closeStream();
+        running = false;
+        backend->stop();
+        backend->close();
+        
+        // Conserver les poids hybrides appris pour le prochain démarrage, et
+        // dans le profil s'ils ont changé (les autres paramètres n'y sont
+        // enregistrés que par la calibration)
+        if (streamConfig.inputChannels >= 2) {
+            hybrid.stopAdaptation();
+            std::vector<float> weights = hybrid.getWeights();
+            if (weights != adaptiveWeights) {
+                adaptiveWeights = std::move(weights);
+                if (saveHybridState()) {
+                    std::cout << "Poids hybrides enregistrés dans le profil" << std::endl;
+                }
             }
-            
-            std::cout << "Stream audio arrêté" << std::endl;
-        }
-        catch (const std::exception& e) {
-            std::cerr << "Erreur lors de l'arrêt: " << e.what() << std::endl;
         }
+        arena.unlock();
+        
+        std::cout << "Stream audio arrêté" << std::endl;
     }
 }
 
+// Active l'adaptation automatique de la taille du tampon
+// (les bornes ne sont prises en compte que flux arrêté)
+void NoiseInverter::setAdaptiveBufferSize(bool enabled, unsigned int minFrames, unsigned int maxFrames) {
+    if (running) {
+        adaptiveBuffer = enabled;
+        return;
+    }
+    
+    BufferSizeController::Settings settings;
+    settings.minFrames = minFrames;
+    settings.maxFrames = maxFrames;
+    bufferController = BufferSizeController(settings);
+    bufferController.reset(bufferFrames);
+    adaptiveBuffer = enabled;
+}
+
+// Vrai lorsqu'une source finie (fichier, pipe) a été entièrement traitée
+bool NoiseInverter::isStreamFinished() const {
+    return backend->isFinished();
+}
+
 // Définit les paramètres du traitement
 void NoiseInverter::setParameters(float delayMs, float gain, 
                                 float lowFreq, float highFreq,
@@ -220,6 +497,8 @@ void NoiseInverter::setParameters(float delayMs, float gain,
     if (needFilterUpdate) {
         calculateFilterCoefficients();
     }
+    parameterGeneration.fetch_add(1, std::memory_order_release);
+    NI_TRACE_INSTANT("paramètres", static_cast<double>(filterType));
 }
 
 // Calibration automatique
@@ -239,87 +518,607 @@ std::pair<float, float> NoiseInverter::calibrate() {
     
     std::cout << "Calibration terminée: délai = " << delayMs << " ms, gain = " << gain << std::endl;
     
+    // Enregistrer le résultat pour éviter de recalibrer au prochain démarrage
+    if (saveProfile()) {
+        std::cout << "Profil de calibration enregistré" << std::endl;
+    }
+    
     return {delayMs, gain};
 }
 
 // Récupère les données pour visualisation
+// (les vecteurs ne sont redimensionnés qu'au premier appel)
 void NoiseInverter::getVisualizationData(std::vector<float>& inputSignal, std::vector<float>& outputSignal) {
+    if (inputSignal.size() != vizBufferSize) {
+        inputSignal.resize(vizBufferSize);
+    }
+    if (outputSignal.size() != vizBufferSize) {
+        outputSignal.resize(vizBufferSize);
+    }
+    getVisualizationData(inputSignal.data(), outputSignal.data(), vizBufferSize);
+}
+
+// Copie dans des tampons de l'appelant, sans allocation ; retourne le
+// nombre d'échantillons copiés
+size_t NoiseInverter::getVisualizationData(float* inputSignal, float* outputSignal, size_t capacity) {
     std::lock_guard<std::mutex> lock(vizData.mutex);
-    
-    inputSignal.resize(vizData.inputSignal.size());
-    outputSignal.resize(vizData.outputSignal.size());
-    
-    std::copy(vizData.inputSignal.begin(), vizData.inputSignal.end(), inputSignal.begin());
-    std::copy(vizData.outputSignal.begin(), vizData.outputSignal.end(), outputSignal.begin());
+    size_t count = std::min(capacity, vizData.inputSignal.size());
+    std::copy(vizData.inputSignal.begin(), vizData.inputSignal.begin() + count, inputSignal);
+    std::copy(vizData.outputSignal.begin(), vizData.outputSignal.begin() + count, outputSignal);
+    return count;
 }
 
 // Callback audio statique
-int NoiseInverter::audioCallback(void* outputBuffer, void* inputBuffer,
+int NoiseInverter::audioCallback(float* outputBuffer, const float* inputBuffer,
                                 unsigned int nFrames, double streamTime,
-                                RtAudioStreamStatus status, void* userData) {
+                                unsigned int status, void* userData) {
+    
+    // Section temps réel (contrôlée en mode d'audit)
+    NI_RT_SECTION();
+    NI_TRACE_SCOPE("callback", nFrames);
     
     NoiseInverter* self = static_cast<NoiseInverter*>(userData);
-    return self->processAudio(static_cast<float*>(outputBuffer), 
-                             static_cast<float*>(inputBuffer),
-                             nFrames);
+    auto begin = std::chrono::steady_clock::now();
+    self->lastCallbackNs.store(steadyNanoseconds(begin), std::memory_order_relaxed);
+    if (status != STREAM_OK) {
+        self->blockEvents |= EventChannel::XRUN;
+    }
+    
+    int result = self->processAudio(outputBuffer, inputBuffer, nFrames);
+    
+    // Charge du callback (durée / période) et xruns, pour l'adaptation du tampon
+    float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count();
+    float load = elapsed * self->sampleRate / nFrames;
+    float currentMax = self->callbackLoadMax.load(std::memory_order_relaxed);
+    while (load > currentMax &&
+           !self->callbackLoadMax.compare_exchange_weak(currentMax, load, std::memory_order_relaxed)) {
+    }
+    if (status != STREAM_OK) {
+        self->xrunCount.fetch_add(1, std::memory_order_relaxed);
+        NI_TRACE_INSTANT("xrun", status);
+        trace::requestDump(trace::DUMP_ON_XRUN);
+    }
+    
+    return result;
+}
+
+// Exécute un noyau, en découpant le bloc s'il dépasse la marge du tampon de délai
+template <typename Fn, typename Context>
+static inline void runKernel(Fn fn, Context& ctx, float* out, const float* in,
+                             unsigned int nFrames, unsigned int outChannels, unsigned int maxChunk) {
+    if (nFrames <= maxChunk) {
+        fn(ctx, out, in, nFrames);
+        return;
+    }
+    
+    for (unsigned int done = 0; done < nFrames; done += maxChunk) {
+        unsigned int count = std::min(maxChunk, nFrames - done);
+        fn(ctx, out + done * outChannels, in + done, count);
+    }
 }
 
 // Traitement audio interne
-int NoiseInverter::processAudio(float* outputBuffer, float* inputBuffer, unsigned int nFrames) {
+int NoiseInverter::processAudio(float* outputBuffer, const float* inputBuffer, unsigned int nFrames) {
     // Supprimer la vérification du status
     
-    // Calcul du délai en échantillons
-    int delaySamples = static_cast<int>(delayMs * sampleRate / 1000.0f);
+    // Changement de mode : l'état du mode quitté n'est plus à jour.
+    // Le mode hybride exige l'entrée du micro d'erreur.
+    const unsigned int inputChannels = streamConfig.inputChannels;
+    EngineMode mode = static_cast<EngineMode>(engineMode.load(std::memory_order_relaxed));
+    if (mode == HYBRID && inputChannels < 2) {
+        mode = BROADBAND;
+    }
+    if (mode != activeMode) {
+        if (mode == BROADBAND) {
+            std::fill(std::begin(filterState), std::end(filterState), 0.0f);
+#ifdef NOISE_INVERTER_FIXED_POINT
+            std::fill(delayBufferQ15.begin(), delayBufferQ15.end(), 0);
+            std::fill(std::begin(filterStateQ31), std::end(filterStateQ31), 0);
+#else
+            std::fill(delayBuffer.begin(), delayBuffer.end(), 0.0f);
+#endif
+        } else if (mode == TONAL) {
+            tonal.reset();
+        }
+        activeMode = mode;
+    }
     
-    // Bloquer le mutex pour la mise à jour des données visualisées
-    {
-        std::lock_guard<std::mutex> lock(vizData.mutex);
-        
+    if (mode == HYBRID) {
+        NI_TRACE_SCOPE("hybride");
+        hybrid.process(outputBuffer, inputBuffer, nFrames, outputChannels);
+        captureOutput(outputBuffer, inputBuffer, inputChannels, nFrames);
+    } else if (inputChannels == 1) {
+        processMono(outputBuffer, inputBuffer, nFrames);
+    } else {
+        // Entrée multicanal : seul le micro de référence (canal 0) est traité
+        unsigned int done = 0;
+        while (done < nFrames) {
+            unsigned int chunk = std::min<unsigned int>(nFrames - done, static_cast<unsigned int>(referenceScratch.size()));
+            if (chunk == 0) {
+                std::fill(outputBuffer + done * outputChannels, outputBuffer + nFrames * outputChannels, 0.0f);
+                break;
+            }
+            for (unsigned int i = 0; i < chunk; i++) {
+                referenceScratch[i] = inputBuffer[(done + i) * inputChannels];
+            }
+            processMono(outputBuffer + done * outputChannels, referenceScratch.data(), chunk);
+            done += chunk;
+        }
+    }
+    
+    // Fondus autour d'un redémarrage du flux
+    if (fadeRequest.load(std::memory_order_relaxed) != FADE_NONE || fadeStep != 0.0f || fadeGain != 1.0f) {
+        NI_TRACE_SCOPE("fondu");
+        applyFade(outputBuffer, nFrames);
+    }
+    
+    // Paramètres modifiés depuis le bloc précédent
+    unsigned int generation = parameterGeneration.load(std::memory_order_acquire);
+    if (generation != appliedParameterGeneration) {
+        appliedParameterGeneration = generation;
+        blockEvents |= EventChannel::PARAMETERS_APPLIED;
+    }
+    
+    // Événements du bloc pour l'interface : une seule opération atomique,
+    // distribués par le thread du canal
+    events.post(blockEvents);
+    blockEvents = 0;
+    
+    return 0;
+}
+
+// Traitement d'une entrée mono par le mode courant (large bande ou tonal)
+void NoiseInverter::processMono(float* outputBuffer, const float* inputBuffer, unsigned int nFrames) {
+    if (activeMode == TONAL) {
+        NI_TRACE_SCOPE("tonal");
+        processTonal(outputBuffer, inputBuffer, nFrames);
+    } else {
+        NI_TRACE_SCOPE("large bande");
+        processBroadband(outputBuffer, inputBuffer, nFrames);
+    }
+}
+
+// Mode large bande : filtre, retard et inversion (noyau spécialisé)
+void NoiseInverter::processBroadband(float* outputBuffer, const float* inputBuffer, unsigned int nFrames) {
+#ifdef NOISE_INVERTER_FIXED_POINT
+    processBroadbandFixed(outputBuffer, inputBuffer, nFrames);
+#else
+    const KernelEntry* kernel = activeKernel.load(std::memory_order_acquire);
+    
+    // Calcul du délai en échantillons (borné à 50ms, soit la moitié du tampon)
+    size_t delaySamples = static_cast<size_t>(delayMs * sampleRate / 1000.0f);
+    delaySamples = std::min(delaySamples, delayBufferSize / 2);
+    
+    // Taille maximale d'un sous-bloc pour ne pas écraser le signal retardé
+    unsigned int maxChunk = static_cast<unsigned int>(delayBufferSize - delaySamples);
+    
+    // Préparer le contexte du bloc à partir de l'état du moteur
+    KernelContext ctx;
+    ctx.b0 = b[0];
+    ctx.b1 = b[1];
+    ctx.b2 = b[2];
+    ctx.a1 = a[1];
+    ctx.a2 = a[2];
+    ctx.x1 = filterState[0];
+    ctx.x2 = filterState[1];
+    ctx.y1 = filterState[2];
+    ctx.y2 = filterState[3];
+    ctx.negGain = -gain;
+    ctx.delayBuffer = delayBuffer.data();
+    ctx.delayBufferSize = delayBufferSize;
+    ctx.writePos = delayBufferPos;
+    ctx.readPos = (delayBufferPos + delayBufferSize - delaySamples) % delayBufferSize;
+    
+    // Mise à jour des données visualisées uniquement si le mutex est libre :
+    // le thread audio ne doit jamais attendre l'interface
+    std::unique_lock<std::mutex> vizLock;
+    if (kernel->usesViz) {
+        vizLock = std::unique_lock<std::mutex>(vizData.mutex, std::try_to_lock);
+        if (!vizLock.owns_lock()) {
+            kernel = selectKernel(kernel->topology, outputChannels, false, kernel->usesMeter);
+        }
+    }
+    
+    if (kernel->usesViz) {
+        ctx.vizInput = vizData.inputSignal.data();
+        ctx.vizOutput = vizData.outputSignal.data();
+        ctx.vizBufferSize = vizBufferSize;
+    }
+    runKernel(kernel->fn, ctx, outputBuffer, inputBuffer, nFrames, outputChannels, maxChunk);
+    
+    if (vizLock.owns_lock()) {
+        vizLock.unlock();
+        blockEvents |= EventChannel::VISUALIZATION;
+    }
+    
+    // Sauvegarder l'état du filtre et de la ligne de retard
+    filterState[0] = ctx.x1;
+    filterState[1] = ctx.x2;
+    filterState[2] = ctx.y1;
+    filterState[3] = ctx.y2;
+    delayBufferPos = ctx.writePos;
+    
+    if (kernel->usesMeter && nFrames > 0) {
+        outputPeak.store(ctx.peak, std::memory_order_relaxed);
+        outputRms.store(std::sqrt(ctx.sumSquares / nFrames), std::memory_order_relaxed);
+        blockEvents |= EventChannel::METER;
+    }
+#endif
+}
+
+#ifdef NOISE_INVERTER_FIXED_POINT
+// Mode large bande en virgule fixe ; visualisation et mesure de niveau
+// sont faites sur la sortie reconvertie, comme pour les autres modes
+void NoiseInverter::processBroadbandFixed(float* outputBuffer, const float* inputBuffer, unsigned int nFrames) {
+    const KernelEntry* kernel = activeKernel.load(std::memory_order_acquire);
+    
+    size_t delaySamples = static_cast<size_t>(delayMs * sampleRate / 1000.0f);
+    delaySamples = std::min(delaySamples, delayBufferSize / 2);
+    unsigned int maxChunk = static_cast<unsigned int>(delayBufferSize - delaySamples);
+    
+    // Coefficients convertis à chaque bloc : le gain peut changer sans
+    // recalcul du filtre
+    KernelContext coefficients;
+    coefficients.b0 = b[0];
+    coefficients.b1 = b[1];
+    coefficients.b2 = b[2];
+    coefficients.a1 = a[1];
+    coefficients.a2 = a[2];
+    coefficients.negGain = -gain;
+    
+    fixedpoint::FixedKernelContext ctx;
+    fixedpoint::loadCoefficients(ctx, coefficients);
+    ctx.x1 = filterStateQ31[0];
+    ctx.x2 = filterStateQ31[1];
+    ctx.y1 = filterStateQ31[2];
+    ctx.y2 = filterStateQ31[3];
+    ctx.residue = filterStateQ31[4];
+    ctx.delayBuffer = delayBufferQ15.data();
+    ctx.delayBufferSize = delayBufferSize;
+    ctx.writePos = delayBufferPos;
+    ctx.readPos = (delayBufferPos + delayBufferSize - delaySamples) % delayBufferSize;
+    
+    runKernel(fixedpoint::selectKernel(kernel->topology, outputChannels), ctx,
+              outputBuffer, inputBuffer, nFrames, outputChannels, maxChunk);
+    
+    filterStateQ31[0] = ctx.x1;
+    filterStateQ31[1] = ctx.x2;
+    filterStateQ31[2] = ctx.y1;
+    filterStateQ31[3] = ctx.y2;
+    filterStateQ31[4] = ctx.residue;
+    delayBufferPos = ctx.writePos;
+    
+    captureOutput(outputBuffer, inputBuffer, 1, nFrames);
+}
+#endif
+
+// Mode tonal : anti-bruit synthétisé par le banc d'oscillateurs
+void NoiseInverter::processTonal(float* outputBuffer, const float* inputBuffer, unsigned int nFrames) {
+    // Le signal étant périodique, l'anti-bruit est avancé de la latence
+    // d'entrée/sortie ; le délai réglé reste un retard supplémentaire
+    float advanceSamples = (measuredLatency - delayMs) * sampleRate / 1000.0f;
+    tonal.process(outputBuffer, inputBuffer, nFrames, outputChannels, gain, advanceSamples);
+    captureOutput(outputBuffer, inputBuffer, 1, nFrames);
+}
+
+// Visualisation et mesure de niveau pour les modes hors noyaux spécialisés
+void NoiseInverter::captureOutput(const float* outputBuffer, const float* inputBuffer,
+                                  unsigned int inputStride, unsigned int nFrames) {
+    if (vizEnabled.load(std::memory_order_relaxed)) {
+        std::unique_lock<std::mutex> vizLock(vizData.mutex, std::try_to_lock);
+        if (vizLock.owns_lock()) {
+            // Un échantillon sur deux, comme les noyaux large bande
+            size_t vizPos = 0;
+            for (unsigned int i = 0; i < nFrames; i += 2) {
+                vizData.inputSignal[vizPos] = inputBuffer[i * inputStride];
+                vizData.outputSignal[vizPos] = outputBuffer[i * outputChannels];
+                vizPos = (vizPos + 1 == vizBufferSize) ? 0 : vizPos + 1;
+            }
+            blockEvents |= EventChannel::VISUALIZATION;
+        }
+    }
+    
+    if (meteringEnabled.load(std::memory_order_relaxed) && nFrames > 0) {
+        float peak = 0.0f;
+        float sumSquares = 0.0f;
         for (unsigned int i = 0; i < nFrames; i++) {
-            // Obtenir l'échantillon d'entrée
-            float input = inputBuffer[i];
-            
-            // Appliquer le filtre
-            float filtered = applyFilter(input);
-            
-            // Inverser le signal filtré
-            float inverted = -filtered * gain;
-            
-            // Stocker dans le tampon de délai
-            delayBuffer[delayBufferPos] = inverted;
-            
-            // Lire l'échantillon retardé
-            size_t readPos = (delayBufferPos + delayBufferSize - delaySamples) % delayBufferSize;
-            float delayed = delayBuffer[readPos];
-            
-            // Avancer la position d'écriture
-            delayBufferPos = (delayBufferPos + 1) % delayBufferSize;
-            
-            // Ajouter le signal d'origine et le signal inversé retardé
-            float output = input + delayed;
+            float sample = outputBuffer[i * outputChannels];
+            peak = std::max(peak, std::fabs(sample));
+            sumSquares += sample * sample;
+        }
+        outputPeak.store(peak, std::memory_order_relaxed);
+        outputRms.store(std::sqrt(sumSquares / nFrames), std::memory_order_relaxed);
+        blockEvents |= EventChannel::METER;
+    }
+}
+
+// Choisit le mode d'annulation. Le mode hybride ouvre une seconde entrée
+// (micro d'erreur) : demandé en cours de traitement avec une seule entrée,
+// il ne prend effet qu'au prochain démarrage et retourne false.
+bool NoiseInverter::setEngineMode(EngineMode mode) {
+    engineMode.store(mode, std::memory_order_relaxed);
+    parameterGeneration.fetch_add(1, std::memory_order_release);
+    return mode != HYBRID || !running || streamConfig.inputChannels >= 2;
+}
+
+// Paramètres du mode tonal (0 pour laisser inchangé)
+void NoiseInverter::setTonalParameters(float fundamentalHz, unsigned int harmonics, float stepSize) {
+    tonal.configure(fundamentalHz, harmonics, stepSize);
+    parameterGeneration.fetch_add(1, std::memory_order_release);
+}
+
+// Mise à jour de l'interface sur le thread du canal d'événements
+void NoiseInverter::setUpdateCallback(std::function<void()> callback) {
+    if (!callback) {
+        events.setCallback(nullptr);
+        return;
+    }
+    events.setCallback([callback = std::move(callback)](uint32_t) { callback(); });
+}
+
+// Applique le fondu en cours (thread audio uniquement)
+void NoiseInverter::applyFade(float* outputBuffer, unsigned int nFrames) {
+    int request = fadeRequest.exchange(FADE_NONE, std::memory_order_relaxed);
+    float fadeLength = std::max(1.0f, sampleRate * fadeDurationMs / 1000.0f);
+    if (request == FADE_OUT) {
+        fadeStep = -1.0f / fadeLength;
+    } else if (request == FADE_IN) {
+        fadeStep = 1.0f / fadeLength;
+    } else if (request == FADE_IN_FROM_ZERO) {
+        fadeGain = 0.0f;
+        fadeStep = 1.0f / fadeLength;
+    }
+    
+    for (unsigned int i = 0; i < nFrames; i++) {
+        fadeGain = std::max(0.0f, std::min(1.0f, fadeGain + fadeStep));
+        for (unsigned int c = 0; c < outputChannels; c++) {
+            outputBuffer[i * outputChannels + c] *= fadeGain;
+        }
+    }
+    
+    if (fadeStep < 0.0f && fadeGain == 0.0f) {
+        fadeStep = 0.0f;
+        fadeOutComplete = true;
+    } else if (fadeStep > 0.0f && fadeGain == 1.0f) {
+        fadeStep = 0.0f;
+    }
+}
+
+// Simulation hors ligne : traite du bruit synthétique sur un thread dédié
+// en passant par le même callback que le flux audio, sans périphérique.
+// Les paramètres changent régulièrement pour exercer tous les noyaux.
+bool NoiseInverter::runSimulation(unsigned int blocks) {
+    if (running) {
+        return false;
+    }
+    
+    // Tampons préparés à l'avance (hors section temps réel). Deux voies
+    // d'entrée (référence, micro d'erreur) pour couvrir aussi le mode hybride.
+    const unsigned int nFrames = bufferFrames;
+    std::vector<float> input(nFrames * 2 * 16);
+    std::vector<float> output(nFrames * outputChannels);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    for (float& sample : input) {
+        sample = noise(rng);
+    }
+    
+    streamConfig.inputChannels = 2;
+    hybrid.prepare(secondaryPath, 2 * nFrames, std::vector<float>());
+    hybrid.startAdaptation();
+    lockEngineState();
+    
+    // Régime établi : aucune allocation sur le tas, quel que soit le thread
+    // (traitement, adaptation hybride), entre le premier et le dernier bloc
+    static const EngineMode modes[5] = {BROADBAND, BROADBAND, BROADBAND, TONAL, HYBRID};
+    std::thread audioThread([&]() {
+        size_t allocationsBefore = rtaudit::allocationCount();
+        for (unsigned int block = 0; block < blocks; block++) {
+            if (block % 64 == 0) {
+                unsigned int step = block / 64;
+                setParameters(static_cast<float>(step % 20), 0.9f, -1.0f, -1.0f,
+                              static_cast<FilterType>(step % 3));
+                setEngineMode(modes[step % 5]);
+                setVisualizationEnabled(step % 2 == 0);
+                setMeteringEnabled(step % 4 < 2);
+            }
             
-            // Limiter la sortie pour éviter l'écrêtage
-            output = std::max(-1.0f, std::min(1.0f, output));
+            float* in = input.data() + (block % 16) * nFrames * 2;
+            audioCallback(output.data(), in, nFrames, block * nFrames / double(sampleRate), 0, this);
+        }
+        simulationAllocations = rtaudit::allocationCount() - allocationsBefore;
+    });
+    audioThread.join();
+    hybrid.stopAdaptation();
+    arena.unlock();
+    streamConfig.inputChannels = 1;
+    
+    return true;
+}
+
+// Comparaison flottant / virgule fixe : les deux chaînes traitent le même
+// bruit avec les coefficients du moteur, par blocs de bufferFrames. La
+// sortie flottante, quantifiée en Q15 comme le ferait un convertisseur,
+// sert de référence au bit près ; l'écart à la sortie flottante non
+// quantifiée donne le plancher de bruit de la chaîne entière.
+std::vector<NoiseInverter::FixedPointComparison> NoiseInverter::compareFixedPoint(unsigned int blocks) {
+    std::vector<FixedPointComparison> results;
+    if (running || blocks == 0) {
+        return results;
+    }
+    
+    const unsigned int nFrames = bufferFrames;
+    const size_t total = static_cast<size_t>(blocks) * nFrames;
+    std::vector<float> input(total);
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> noise(-0.5f, 0.5f);
+    for (float& sample : input) {
+        sample = noise(rng);
+    }
+    std::vector<float> floatOutput(total * outputChannels);
+    std::vector<float> fixedOutput(total * outputChannels);
+    std::vector<float> floatDelay(delayBufferSize);
+    std::vector<int16_t> fixedDelay(delayBufferSize);
+    
+    size_t delaySamples = static_cast<size_t>(delayMs * sampleRate / 1000.0f);
+    delaySamples = std::min(delaySamples, delayBufferSize / 2);
+    const unsigned int maxChunk = static_cast<unsigned int>(delayBufferSize - delaySamples);
+    const size_t readPos = delayBufferSize - delaySamples;
+    
+    using Clock = std::chrono::steady_clock;
+    const FilterType savedType = currentFilterType;
+    static const FilterType types[3] = {BANDPASS, LOWPASS, HIGHPASS};
+    for (FilterType type : types) {
+        setParameters(-1.0f, -1.0f, -1.0f, -1.0f, type);
+        KernelFn floatKernel = selectKernel(topologyFor(type), outputChannels, false, false)->fn;
+        fixedpoint::FixedKernelFn fixedKernel = fixedpoint::selectKernel(topologyFor(type), outputChannels);
+        
+        // Deux passes par chaîne : la première amène données et code en cache
+        double floatSeconds = 0.0;
+        double fixedSeconds = 0.0;
+        for (int pass = 0; pass < 2; pass++) {
+            KernelContext ctx;
+            ctx.b0 = b[0];
+            ctx.b1 = b[1];
+            ctx.b2 = b[2];
+            ctx.a1 = a[1];
+            ctx.a2 = a[2];
+            ctx.negGain = -gain;
+            ctx.delayBuffer = floatDelay.data();
+            ctx.delayBufferSize = delayBufferSize;
+            ctx.readPos = readPos % delayBufferSize;
+            std::fill(floatDelay.begin(), floatDelay.end(), 0.0f);
             
-            // Copier sur les deux canaux (stéréo)
-            outputBuffer[i*2] = output;
-            outputBuffer[i*2 + 1] = output;
+            fixedpoint::FixedKernelContext fixedCtx;
+            fixedpoint::loadCoefficients(fixedCtx, ctx);
+            fixedCtx.delayBuffer = fixedDelay.data();
+            fixedCtx.delayBufferSize = delayBufferSize;
+            fixedCtx.readPos = readPos % delayBufferSize;
+            std::fill(fixedDelay.begin(), fixedDelay.end(), 0);
             
-            // Mettre à jour les données de visualisation (à une fréquence moins élevée)
-            if (i % 2 == 0) {  // Ne mettre à jour qu'un échantillon sur deux
-                size_t vizPos = (i / 2) % vizBufferSize;
-                vizData.inputSignal[vizPos] = input;
-                vizData.outputSignal[vizPos] = output;
+            auto begin = Clock::now();
+            for (unsigned int block = 0; block < blocks; block++) {
+                size_t offset = static_cast<size_t>(block) * nFrames;
+                runKernel(floatKernel, ctx, &floatOutput[offset * outputChannels], &input[offset],
+                          nFrames, outputChannels, maxChunk);
+            }
+            auto middle = Clock::now();
+            for (unsigned int block = 0; block < blocks; block++) {
+                size_t offset = static_cast<size_t>(block) * nFrames;
+                runKernel(fixedKernel, fixedCtx, &fixedOutput[offset * outputChannels], &input[offset],
+                          nFrames, outputChannels, maxChunk);
             }
+            auto end = Clock::now();
+            floatSeconds = std::chrono::duration<double>(middle - begin).count();
+            fixedSeconds = std::chrono::duration<double>(end - middle).count();
         }
+        
+        FixedPointComparison result;
+        result.filterType = type;
+        size_t exact = 0;
+        double maxError = 0.0;
+        double errorEnergy = 0.0;
+        for (size_t i = 0; i < total; i++) {
+            float reference = floatOutput[i * outputChannels];
+            float fixed = fixedOutput[i * outputChannels];
+            float quantized = static_cast<float>(std::lrint(std::max(-1.0f, std::min(32767.0f / 32768.0f, reference)) * 32768.0f)) / 32768.0f;
+            if (fixed == quantized) {
+                exact++;
+            }
+            maxError = std::max(maxError, std::fabs(static_cast<double>(fixed) - quantized) * 32768.0);
+            double error = static_cast<double>(fixed) - reference;
+            errorEnergy += error * error;
+        }
+        result.exactRatio = static_cast<double>(exact) / total;
+        result.maxErrorLsb = maxError;
+        result.noiseFloorDb = 10.0 * std::log10(std::max(errorEnergy / total, 1e-30));
+        result.floatNsPerFrame = floatSeconds * 1e9 / total;
+        result.fixedNsPerFrame = fixedSeconds * 1e9 / total;
+        results.push_back(result);
     }
+    setParameters(-1.0f, -1.0f, -1.0f, -1.0f, savedType);
     
-    // Appeler le callback de mise à jour de l'interface si défini
-    if (updateCallback) {
-        updateCallback();
+    return results;
+}
+
+// Prépare le moteur pour un hôte (multizone, interface C) : flux et thread
+// de surveillance appartiennent à l'hôte. Les paramètres restent
+// modifiables ensuite comme pour un flux démarré.
+bool NoiseInverter::prepareHosted(unsigned int rate, unsigned int frames,
+                                  unsigned int inputChannels, unsigned int channels) {
+    std::lock_guard<std::mutex> lock(streamMutex);
+    if (running) {
+        return false;
     }
     
-    return 0;
+    streamConfig = StreamConfig();
+    streamConfig.inputChannels = std::max(1u, std::min(2u, inputChannels));
+    streamConfig.outputChannels = std::max(1u, std::min(2u, channels));
+    streamConfig.sampleRate = rate;
+    streamConfig.bufferFrames = frames;
+    streamConfig.streamName = "NoiseInverter (zone)";
+    
+    outputChannels = streamConfig.outputChannels;
+    bufferFrames = frames;
+    if (rate != sampleRate) {
+        sampleRate = rate;
+        allocateBuffers();
+    }
+    calculateFilterCoefficients();
+    measuredLatency = (bufferFrames * 1000.0f) / sampleRate * 2.0f;
+    
+    if (streamConfig.inputChannels >= 2) {
+        hybrid.prepare(secondaryPath, 2 * bufferFrames, adaptiveWeights);
+        hybrid.startAdaptation();
+    }
+    
+    lockEngineState();
+    running = true;
+    return true;
+}
+
+// Traite un bloc pour l'hôte (thread de travail temps réel)
+void NoiseInverter::processHosted(float* outputBuffer, const float* inputBuffer, unsigned int nFrames) {
+    processAudio(outputBuffer, inputBuffer, nFrames);
+}
+
+// Remise à zéro de l'état du traitement (hôte suspendu, aucun bloc en cours)
+void NoiseInverter::resetHosted() {
+    std::lock_guard<std::mutex> lock(streamMutex);
+    if (!running) {
+        return;
+    }
+    delayBufferPos = 0;
+    std::fill(std::begin(filterState), std::end(filterState), 0.0f);
+#ifdef NOISE_INVERTER_FIXED_POINT
+    std::fill(delayBufferQ15.begin(), delayBufferQ15.end(), 0);
+    std::fill(std::begin(filterStateQ31), std::end(filterStateQ31), 0);
+#else
+    std::fill(delayBuffer.begin(), delayBuffer.end(), 0.0f);
+#endif
+    tonal.reset();
+    if (streamConfig.inputChannels >= 2) {
+        hybrid.stopAdaptation();
+        adaptiveWeights = hybrid.getWeights();
+        hybrid.prepare(secondaryPath, 2 * bufferFrames, adaptiveWeights);
+        hybrid.startAdaptation();
+    }
+    outputPeak.store(0.0f, std::memory_order_relaxed);
+    outputRms.store(0.0f, std::memory_order_relaxed);
+}
+
+// Fin de l'hébergement (hôte arrêté)
+void NoiseInverter::releaseHosted() {
+    std::lock_guard<std::mutex> lock(streamMutex);
+    if (!running) {
+        return;
+    }
+    running = false;
+    if (streamConfig.inputChannels >= 2) {
+        hybrid.stopAdaptation();
+        adaptiveWeights = hybrid.getWeights();
+    }
+    arena.unlock();
 }
 
 // Calcule les coefficients du filtre selon le type sélectionné
@@ -367,34 +1166,126 @@ void NoiseInverter::calculateFilterCoefficients() {
     }
     
     // Réinitialiser les états du filtre
-    z1[0] = 0.0f;
-    z1[1] = 0.0f;
+    std::fill(std::begin(filterState), std::end(filterState), 0.0f);
+#ifdef NOISE_INVERTER_FIXED_POINT
+    std::fill(std::begin(filterStateQ31), std::end(filterStateQ31), 0);
+#endif
+    
+    // La topologie dépend du type de filtre
+    selectProcessingKernel();
 }
 
-// Applique le filtre IIR
-float NoiseInverter::applyFilter(float input) {
-    // Équation aux différences du filtre IIR
-    float output = b[0] * input + z1[0];
-    z1[0] = b[1] * input - a[1] * output + z1[1];
-    z1[1] = b[2] * input - a[2] * output;
-    
-    return output;
+// Choisit le noyau de traitement selon la configuration courante
+void NoiseInverter::selectProcessingKernel() {
+    activeKernel.store(selectKernel(topologyFor(currentFilterType), outputChannels, vizEnabled, meteringEnabled),
+                       std::memory_order_release);
+    NI_TRACE_INSTANT("noyau", static_cast<double>(topologyFor(currentFilterType)));
+}
+
+// Topologie effective d'un type de filtre
+FilterTopology NoiseInverter::topologyFor(FilterType type) {
+    switch (type) {
+        case LOWPASS:  return FilterTopology::ONE_POLE_LOWPASS;
+        case HIGHPASS: return FilterTopology::ONE_POLE_HIGHPASS;
+        case BANDPASS:
+        default:       return FilterTopology::BIQUAD_BANDPASS;
+    }
 }
 
-// Thread de surveillance de la charge CPU
-void NoiseInverter::cpuMonitorThread() {
-    auto lastTime = std::chrono::high_resolution_clock::now();
+// Active ou désactive la mise à jour des données de visualisation
+void NoiseInverter::setVisualizationEnabled(bool enabled) {
+    vizEnabled = enabled;
+    selectProcessingKernel();
+}
+
+// Active ou désactive la mesure du niveau de sortie
+void NoiseInverter::setMeteringEnabled(bool enabled) {
+    meteringEnabled = enabled;
+    if (!enabled) {
+        outputPeak = 0.0f;
+        outputRms = 0.0f;
+    }
+    selectProcessingKernel();
+}
+
+// Thread de surveillance : charge CPU et taille du tampon à chaque fenêtre,
+// santé du flux (battements du callback, état du backend) à chaque tick
+void NoiseInverter::monitorThread() {
+    using Clock = std::chrono::steady_clock;
+    auto lastTime = Clock::now();
+    auto windowStart = lastTime;
+    auto nextRecovery = lastTime;
+    bool faultPending = false;
+    trace::setThreadName("surveillance");
     
-    while (running) {
-        // Attendre 1 seconde
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        
+    while (!monitorSleep(std::chrono::milliseconds(watchdogIntervalMs))) {
         try {
+            // Exports de trace demandés (signal, xrun)
+            trace::serviceDumps();
+            
+            auto currentTime = Clock::now();
+            
+            // Santé du flux. isRunning avant isFinished : les backends marquent
+            // la fin du flux avant de s'arrêter, une source épuisée n'est pas une panne.
+            bool streamRunning = backend->isRunning();
+            if (!backend->isFinished()) {
+                Clock::time_point lastCallback(std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::nanoseconds(lastCallbackNs.load(std::memory_order_relaxed))));
+                bool deviceLost = !streamRunning;
+                bool stalled = !deviceLost && backend->isRealtime() && currentTime - lastCallback > stallTimeout();
+                if ((deviceLost || stalled) && currentTime >= nextRecovery) {
+                    auto silenceMs = std::chrono::duration<double, std::milli>(currentTime - lastCallback).count();
+                    NI_TRACE_INSTANT(deviceLost ? "périphérique perdu" : "flux bloqué", silenceMs);
+                    if (!faultPending) {
+                        std::lock_guard<std::mutex> lock(monitorMutex);
+                        if (deviceLost) {
+                            watchdogStats.deviceLosses++;
+                        } else {
+                            watchdogStats.stalls++;
+                        }
+                    }
+                    std::cerr << (deviceLost ? "Flux interrompu par le périphérique" : "Flux bloqué")
+                              << " (aucun callback depuis " << silenceMs << " ms), réouverture..." << std::endl;
+                    
+                    // En cas d'échec, nouvel essai après recoveryBackoffMs
+                    faultPending = !recoverStream(lastCallback);
+                    if (faultPending) {
+                        nextRecovery = Clock::now() + std::chrono::milliseconds(recoveryBackoffMs);
+                    }
+                    continue;
+                }
+            }
+            
+            // Fenêtre d'observation de la charge
+            if (currentTime - windowStart < std::chrono::milliseconds(monitorWindowMs)) {
+                continue;
+            }
+            windowStart = currentTime;
+            
+            // Adapter la taille du tampon selon la marge du callback
+            float maxLoad = callbackLoadMax.exchange(0.0f);
+            unsigned int xruns = xrunCount.exchange(0);
+            NI_TRACE_COUNTER("charge callback", maxLoad);
+            if (adaptiveBuffer && backend->isRealtime()) {
+                unsigned int newFrames = bufferController.update(maxLoad, xruns);
+                if (newFrames != 0 && newFrames != bufferFrames) {
+                    unsigned int oldFrames = bufferFrames;
+                    auto begin = Clock::now();
+                    if (restartStream(newFrames)) {
+                        auto switchMs = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+                        std::cout << "Tampon adapté: " << oldFrames << " -> " << bufferFrames
+                                  << " échantillons (charge " << maxLoad << ", xruns " << xruns
+                                  << ", bascule " << switchMs << " ms)" << std::endl;
+                    }
+                    // En cas d'échec la taille précédente a été conservée
+                    bufferController.syncCurrentFrames(bufferFrames);
+                }
+            }
+            
             // Comme getStreamCpuLoad n'est pas disponible, conservons simplement la valeur existante
             // ou utilisons une méthode alternative pour estimer la charge CPU
             
             // Vérifier si nous avons toujours une bonne latence
-            auto currentTime = std::chrono::high_resolution_clock::now();
             auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
                 currentTime - lastTime).count();
             
@@ -408,4 +1299,112 @@ void NoiseInverter::cpuMonitorThread() {
             std::cerr << "Erreur dans le thread de surveillance: " << e.what() << std::endl;
         }
     }
-}
\ No newline at end of file
+}
+
+// Demande l'arrêt du thread de surveillance et l'attend (streamMutex libre :
+// une reprise en cours se termine d'abord)
+void NoiseInverter::stopMonitor() {
+    {
+        std::lock_guard<std::mutex> lock(monitorMutex);
+        monitorStop = true;
+    }
+    monitorWake.notify_all();
+    if (monitor.joinable()) {
+        monitor.join();
+    }
+}
+
+// Attente interruptible du thread de surveillance ; vrai si l'arrêt est demandé
+bool NoiseInverter::monitorSleep(std::chrono::milliseconds duration) {
+    std::unique_lock<std::mutex> lock(monitorMutex);
+    return monitorWake.wait_for(lock, duration, [this] { return monitorStop; });
+}
+
+// Durée sans callback au-delà de laquelle un flux cadencé est bloqué
+std::chrono::milliseconds NoiseInverter::stallTimeout() const {
+    uint64_t periodsMs = uint64_t(stallPeriods) * bufferFrames * 1000 / sampleRate;
+    return std::chrono::milliseconds(std::max<uint64_t>(stallMinimumMs, periodsMs));
+}
+
+// Rouvre le flux après une panne, avec la même configuration, jusqu'au retour
+// des callbacks et au plus pendant recoveryTimeoutMs. L'état du moteur et les
+// paramètres sont conservés ; la sortie reprend en fondu d'entrée.
+bool NoiseInverter::recoverStream(std::chrono::steady_clock::time_point lastCallback) {
+    using Clock = std::chrono::steady_clock;
+    NI_TRACE_SCOPE("reprise du flux");
+    auto deadline = Clock::now() + std::chrono::milliseconds(recoveryTimeoutMs);
+    unsigned int attempts = 0;
+    unsigned int retryMs = recoveryRetryMs;
+    
+    while (Clock::now() < deadline) {
+        int64_t opened = 0;
+        {
+            std::lock_guard<std::mutex> lock(streamMutex);
+            if (!running) {
+                return false;
+            }
+            
+            // La latence est inchangée : les poids hybrides appris restent valables
+            if (attempts == 0 && streamConfig.inputChannels >= 2) {
+                hybrid.stopAdaptation();
+                adaptiveWeights = hybrid.getWeights();
+            }
+            
+            backend->stop();
+            backend->close();
+            // Pas de fondu de sortie avant la panne : le premier bloc rouvert
+            // repart du silence (appliqué par le thread audio)
+            fadeRequest = FADE_IN_FROM_ZERO;
+            attempts++;
+            if (openStream()) {
+                opened = lastCallbackNs.load(std::memory_order_relaxed);
+            } else {
+                // Le moteur reste démarré jusqu'à stop()
+                running = true;
+            }
+        }
+        
+        if (opened != 0) {
+            // Reprise confirmée par le premier callback après l'ouverture
+            auto confirm = std::min(deadline, Clock::now() + stallTimeout());
+            while (lastCallbackNs.load(std::memory_order_relaxed) <= opened && Clock::now() < confirm) {
+                if (monitorSleep(std::chrono::milliseconds(1))) {
+                    return false;
+                }
+            }
+            int64_t resumed = lastCallbackNs.load(std::memory_order_relaxed);
+            if (resumed > opened) {
+                double recoveryMs = (resumed - steadyNanoseconds(lastCallback)) / 1e6;
+                {
+                    std::lock_guard<std::mutex> lock(monitorMutex);
+                    watchdogStats.recoveries++;
+                    watchdogStats.lastRecoveryMs = recoveryMs;
+                    watchdogStats.maxRecoveryMs = std::max(watchdogStats.maxRecoveryMs, recoveryMs);
+                    watchdogStats.totalRecoveryMs += recoveryMs;
+                }
+                events.post(EventChannel::STREAM_RECOVERED);
+                std::cout << "Flux rétabli en " << recoveryMs << " ms (" << attempts
+                          << " tentative(s))" << std::endl;
+                return true;
+            }
+        } else if (monitorSleep(std::chrono::milliseconds(retryMs))) {
+            return false;
+        } else {
+            // Espacer les ouvertures tant que le périphérique est absent
+            retryMs = std::min(retryMs * 2, recoveryTimeoutMs / 4);
+        }
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(monitorMutex);
+        watchdogStats.failedRecoveries++;
+    }
+    std::cerr << "Reprise du flux impossible après " << attempts << " tentative(s)" << std::endl;
+    return false;
+}
+
+// Statistiques de la surveillance depuis la construction
+NoiseInverter::WatchdogStats NoiseInverter::getWatchdogStats() const {
+    std::lock_guard<std::mutex> lock(monitorMutex);
+    return watchdogStats;
+}
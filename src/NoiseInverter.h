@@ -1,411 +1,329 @@
-#include "NoiseInverter.h"
+#pragma once
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 #include <chrono>
-#include <algorithm>
-#include <cstring>
-#include <cmath> // pour M_PI
+#include <functional>
+#include <utility>
 
-// Définir M_PI si pas défini
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
+#include "AudioBackend.h"
+#include "EngineArena.h"
+#include "EventChannel.h"
+#include "BufferSizeController.h"
+#include "ProfileStore.h"
+#include "ProcessingKernels.h"
+#include "TonalCanceller.h"
+#include "HybridController.h"
 
-// Constructeur
-NoiseInverter::NoiseInverter() {
-    // Initialiser le tampon de délai (50ms max)
-    delayBufferSize = static_cast<size_t>(sampleRate * 0.050);
-    delayBuffer.resize(delayBufferSize, 0.0f);
-    
-    // Initialiser les buffers de visualisation
-    vizData.inputSignal.resize(vizBufferSize, 0.0f);
-    vizData.outputSignal.resize(vizBufferSize, 0.0f);
-    
-    // Calculer les coefficients du filtre
-    calculateFilterCoefficients();
-    
-    std::cout << "NoiseInverter initialisé - Optimisé pour Focusrite Firewire" << std::endl;
-    std::cout << "Taux d'échantillonnage: " << sampleRate << " Hz" << std::endl;
-    std::cout << "Taille du tampon: " << bufferFrames << " échantillons" << std::endl;
-}
-
-// Destructeur
-NoiseInverter::~NoiseInverter() {
-    stop();
-}
-
-// Liste les périphériques audio disponibles
-std::vector<NoiseInverter::AudioDevice> NoiseInverter::listDevices() {
-    std::vector<AudioDevice> deviceList;
-    
-    // Obtenir les informations sur les périphériques
-    unsigned int deviceCount = audio.getDeviceCount();
-    std::cout << "Périphériques audio disponibles: " << deviceCount << std::endl;
-    
-    for (unsigned int i = 0; i < deviceCount; i++) {
-        RtAudio::DeviceInfo info = audio.getDeviceInfo(i);
-        
-        // Supprimé la vérification de info.probed
-        {
-            // Créer une entrée pour le périphérique d'entrée
-            if (info.inputChannels > 0) {
-                AudioDevice device;
-                device.id = i;
-                device.name = info.name;
-                device.isInput = true;
-                device.isOutput = false;
-                device.isDefault = info.isDefaultInput;
-                device.maxChannels = info.inputChannels;
-                device.sampleRates = info.sampleRates;
-                
-                deviceList.push_back(device);
-                
-                std::cout << "Périphérique " << i << ": " << info.name << " (Entrée)" << std::endl;
-            }
-            
-            // Créer une entrée pour le périphérique de sortie
-            if (info.outputChannels > 0) {
-                AudioDevice device;
-                device.id = i + 1000;  // +1000 pour différencier entrée/sortie
-                device.name = info.name;
-                device.isInput = false;
-                device.isOutput = true;
-                device.isDefault = info.isDefaultOutput;
-                device.maxChannels = info.outputChannels;
-                device.sampleRates = info.sampleRates;
-                
-                deviceList.push_back(device);
-                
-                std::cout << "Périphérique " << i << ": " << info.name << " (Sortie)" << std::endl;
-            }
-            
-            // Afficher les informations détaillées
-            std::cout << "  Entrées: " << info.inputChannels 
-                      << ", Sorties: " << info.outputChannels << std::endl;
-            
-            std::cout << "  Fréquences supportées: ";
-            for (size_t j = 0; j < std::min(size_t(5), info.sampleRates.size()); j++) {
-                std::cout << info.sampleRates[j] << " ";
-            }
-            if (info.sampleRates.size() > 5) {
-                std::cout << "...";
-            }
-            std::cout << std::endl;
-            
-            // Vérifier si c'est un périphérique Focusrite
-            if (info.name.find("Focusrite") != std::string::npos ||
-                info.name.find("Saffire") != std::string::npos) {
-                std::cout << "  *** Périphérique Focusrite détecté! ***" << std::endl;
-            }
-        }
-    }
-    
-    return deviceList;
-}
-
-// Démarre le traitement audio
-bool NoiseInverter::start(int inputDevice, int outputDevice) {
-    if (running) {
-        return true;
-    }
-    
-    try {
-        // Ajuster les indices
-        if (inputDevice >= 1000) {
-            inputDevice -= 1000;
-        }
-        
-        if (outputDevice >= 1000) {
-            outputDevice -= 1000;
-        }
-        
-        RtAudio::StreamParameters inParams;
-        inParams.deviceId = inputDevice;
-        inParams.nChannels = 1;  // Mono pour l'entrée
-        inParams.firstChannel = 0;
-        
-        RtAudio::StreamParameters outParams;
-        outParams.deviceId = outputDevice;
-        outParams.nChannels = 2;  // Stéréo pour la sortie
-        outParams.firstChannel = 0;
-        
-        RtAudio::StreamOptions options;
-        options.flags = RTAUDIO_MINIMIZE_LATENCY | RTAUDIO_SCHEDULE_REALTIME;
-        options.numberOfBuffers = 2;  // Minimiser les buffers
-        options.priority = 85;  // Haute priorité
-        options.streamName = "NoiseInverter";
-        
-        // Ouvrir le stream
-        std::cout << "Ouverture du stream audio..." << std::endl;
-        std::cout << "  Entrée: " << inputDevice << ", Sortie: " << outputDevice << std::endl;
-        std::cout << "  Taux d'échantillonnage: " << sampleRate << " Hz" << std::endl;
-        std::cout << "  Taille du tampon: " << bufferFrames << " échantillons" << std::endl;
-        
-        audio.openStream(&outParams, &inParams, RTAUDIO_FLOAT32,
-                       sampleRate, &bufferFrames, &audioCallback,
-                       this, &options);
-        
-        // Démarrer le stream
-        audio.startStream();
-        
-        // Estimation simple de la latence basée sur la taille du buffer
-        measuredLatency = (bufferFrames * 1000.0f) / sampleRate * 2.0f;
-        
-        std::cout << "Stream audio démarré avec succès!" << std::endl;
-        std::cout << "Taille du tampon effective: " << bufferFrames << " échantillons" << std::endl;
-        std::cout << "Latence estimée: " << measuredLatency << " ms" << std::endl;
-        
-        running = true;
-        
-        // Démarrer un thread pour surveiller la charge CPU
-        std::thread monitorThread(&NoiseInverter::cpuMonitorThread, this);
-        monitorThread.detach();
-        
-        return true;
-    }
-    catch (const std::exception& e) {
-        std::cerr << "Erreur: " << e.what() << std::endl;
-        return false;
-    }
-}
-
-// Arrête le traitement audio
-void NoiseInverter::stop() {
-    if (running) {
-        try {
-            running = false;
-            if (audio.isStreamRunning()) {
-                audio.stopStream();
-            }
-            if (audio.isStreamOpen()) {
-                audio.closeStream();
-            }
-            
-            std::cout << "Stream audio arrêté" << std::endl;
-        }
-        catch (const std::exception& e) {
-            std::cerr << "Erreur lors de l'arrêt: " << e.what() << std::endl;
-        }
-    }
-}
-
-// Définit les paramètres du traitement
-void NoiseInverter::setParameters(float delayMs, float gain, 
-                                float lowFreq, float highFreq,
-                                FilterType filterType) {
-    
-    bool needFilterUpdate = false;
-    
-    if (delayMs >= 0.0f) {
-        this->delayMs = delayMs;
-    }
-    
-    if (gain >= 0.0f) {
-        this->gain = gain;
-    }
-    
-    if (lowFreq >= 0.0f) {
-        this->lowFreq = lowFreq;
-        needFilterUpdate = true;
-    }
-    
-    if (highFreq >= 0.0f) {
-        this->highFreq = highFreq;
-        needFilterUpdate = true;
-    }
-    
-    if (filterType != currentFilterType) {
-        currentFilterType = filterType;
-        needFilterUpdate = true;
-    }
-    
-    if (needFilterUpdate) {
-        calculateFilterCoefficients();
-    }
-}
+// Moteur d'annulation de bruit par inversion de phase
+class NoiseInverter {
+public:
+    // Types de filtre disponibles
+    enum FilterType {
+        BANDPASS = 0,
+        LOWPASS = 1,
+        HIGHPASS = 2
+    };
 
-// Calibration automatique
-std::pair<float, float> NoiseInverter::calibrate() {
-    if (!running) {
-        return {delayMs, gain};
-    }
-    
-    std::cout << "Calibration en cours..." << std::endl;
-    
-    // Utiliser la latence mesurée pour estimer le délai
-    // On utilise un délai légèrement plus court pour la Focusrite
-    delayMs = std::max(1.0f, measuredLatency * 0.5f);  
-    
-    // Gain adapté à la Focusrite
-    gain = 0.92f;
-    
-    std::cout << "Calibration terminée: délai = " << delayMs << " ms, gain = " << gain << std::endl;
-    
-    return {delayMs, gain};
-}
-
-// Récupère les données pour visualisation
-void NoiseInverter::getVisualizationData(std::vector<float>& inputSignal, std::vector<float>& outputSignal) {
-    std::lock_guard<std::mutex> lock(vizData.mutex);
-    
-    inputSignal.resize(vizData.inputSignal.size());
-    outputSignal.resize(vizData.outputSignal.size());
-    
-    std::copy(vizData.inputSignal.begin(), vizData.inputSignal.end(), inputSignal.begin());
-    std::copy(vizData.outputSignal.begin(), vizData.outputSignal.end(), outputSignal.begin());
-}
-
-// Callback audio statique
-int NoiseInverter::audioCallback(void* outputBuffer, void* inputBuffer,
-                                unsigned int nFrames, double streamTime,
-                                RtAudioStreamStatus status, void* userData) {
-    
-    NoiseInverter* self = static_cast<NoiseInverter*>(userData);
-    return self->processAudio(static_cast<float*>(outputBuffer), 
-                             static_cast<float*>(inputBuffer),
-                             nFrames);
-}
-
-// Traitement audio interne
-int NoiseInverter::processAudio(float* outputBuffer, float* inputBuffer, unsigned int nFrames) {
-    // Supprimer la vérification du status
-    
-    // Calcul du délai en échantillons
-    int delaySamples = static_cast<int>(delayMs * sampleRate / 1000.0f);
-    
-    // Bloquer le mutex pour la mise à jour des données visualisées
-    {
-        std::lock_guard<std::mutex> lock(vizData.mutex);
-        
-        for (unsigned int i = 0; i < nFrames; i++) {
-            // Obtenir l'échantillon d'entrée
-            float input = inputBuffer[i];
-            
-            // Appliquer le filtre
-            float filtered = applyFilter(input);
-            
-            // Inverser le signal filtré
-            float inverted = -filtered * gain;
-            
-            // Stocker dans le tampon de délai
-            delayBuffer[delayBufferPos] = inverted;
-            
-            // Lire l'échantillon retardé
-            size_t readPos = (delayBufferPos + delayBufferSize - delaySamples) % delayBufferSize;
-            float delayed = delayBuffer[readPos];
-            
-            // Avancer la position d'écriture
-            delayBufferPos = (delayBufferPos + 1) % delayBufferSize;
-            
-            // Ajouter le signal d'origine et le signal inversé retardé
-            float output = input + delayed;
-            
-            // Limiter la sortie pour éviter l'écrêtage
-            output = std::max(-1.0f, std::min(1.0f, output));
-            
-            // Copier sur les deux canaux (stéréo)
-            outputBuffer[i*2] = output;
-            outputBuffer[i*2 + 1] = output;
-            
-            // Mettre à jour les données de visualisation (à une fréquence moins élevée)
-            if (i % 2 == 0) {  // Ne mettre à jour qu'un échantillon sur deux
-                size_t vizPos = (i / 2) % vizBufferSize;
-                vizData.inputSignal[vizPos] = input;
-                vizData.outputSignal[vizPos] = output;
-            }
-        }
-    }
-    
-    // Appeler le callback de mise à jour de l'interface si défini
-    if (updateCallback) {
-        updateCallback();
-    }
-    
-    return 0;
-}
-
-// Calcule les coefficients du filtre selon le type sélectionné
-void NoiseInverter::calculateFilterCoefficients() {
-    // Fréquences normalisées
-    float omega1 = 2.0f * M_PI * lowFreq / sampleRate;
-    float omega2 = 2.0f * M_PI * highFreq / sampleRate;
-    
-    switch (currentFilterType) {
-        case BANDPASS:
-            // Filtre passe-bande simple du second ordre
-            b[0] = 0.25f;
-            b[1] = 0.0f;
-            b[2] = -0.25f;
-            a[0] = 1.0f;
-            a[1] = -1.5f;
-            a[2] = 0.5f;
-            break;
-            
-        case LOWPASS:
-            // Filtre passe-bas simple
-            {
-                float alpha = std::exp(-omega2);
-                b[0] = 1.0f - alpha;
-                b[1] = 0.0f;
-                b[2] = 0.0f;
-                a[0] = 1.0f;
-                a[1] = -alpha;
-                a[2] = 0.0f;
-            }
-            break;
-            
-        case HIGHPASS:
-            // Filtre passe-haut simple
-            {
-                float alpha = std::exp(-omega1);
-                b[0] = (1.0f + alpha) / 2.0f;
-                b[1] = -(1.0f + alpha) / 2.0f;
-                b[2] = 0.0f;
-                a[0] = 1.0f;
-                a[1] = -alpha;
-                a[2] = 0.0f;
-            }
-            break;
-    }
-    
-    // Réinitialiser les états du filtre
-    z1[0] = 0.0f;
-    z1[1] = 0.0f;
-}
-
-// Applique le filtre IIR
-float NoiseInverter::applyFilter(float input) {
-    // Équation aux différences du filtre IIR
-    float output = b[0] * input + z1[0];
-    z1[0] = b[1] * input - a[1] * output + z1[1];
-    z1[1] = b[2] * input - a[2] * output;
-    
-    return output;
-}
-
-// Thread de surveillance de la charge CPU
-void NoiseInverter::cpuMonitorThread() {
-    auto lastTime = std::chrono::high_resolution_clock::now();
-    
-    while (running) {
-        // Attendre 1 seconde
-        std::this_thread::sleep_for(std::chrono::milliseconds(1000));
-        
-        try {
-            // Comme getStreamCpuLoad n'est pas disponible, conservons simplement la valeur existante
-            // ou utilisons une méthode alternative pour estimer la charge CPU
-            
-            // Vérifier si nous avons toujours une bonne latence
-            auto currentTime = std::chrono::high_resolution_clock::now();
-            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                currentTime - lastTime).count();
-            
-            // Si plus d'une seconde s'est écoulée, afficher les infos CPU
-            if (elapsed > 1000) {
-                std::cout << "Latence: " << measuredLatency << "ms" << std::endl;
-                lastTime = currentTime;
-            }
-        }
-        catch (const std::exception& e) {
-            std::cerr << "Erreur dans le thread de surveillance: " << e.what() << std::endl;
+    // Modes d'annulation : large bande (inversion filtrée), tonal
+    // (fondamental suivi et harmoniques synthétisées) ou hybride
+    // (anticipation + rétroaction adaptatives, micro d'erreur sur l'entrée 2)
+    enum EngineMode {
+        BROADBAND = 0,
+        TONAL = 1,
+        HYBRID = 2
+    };
+
+    // Description d'un périphérique audio
+    using AudioDevice = ::AudioDevice;
+
+    // Constructeur / destructeur
+    explicit NoiseInverter(std::unique_ptr<AudioBackend> audioBackend = nullptr);
+    ~NoiseInverter();
+
+    // Remplace le backend audio (NullBackend par défaut), flux arrêté uniquement
+    bool setBackend(std::unique_ptr<AudioBackend> newBackend);
+    AudioBackend& getBackend() { return *backend; }
+
+    // Profils de calibration et cache des périphériques (désactivés par défaut)
+    bool openProfileStore(const std::string& directory);
+
+    // Application du profil enregistré au démarrage (activée par défaut)
+    void setProfileLoading(bool enabled) { profileLoading = enabled; }
+
+    // Liste les périphériques audio disponibles (cache sauf si refresh)
+    std::vector<AudioDevice> listDevices(bool refresh = false);
+
+    // Démarre / arrête le traitement audio
+    bool start(int inputDevice, int outputDevice);
+    void stop();
+
+    // Vrai lorsqu'une source finie (fichier, pipe) a été entièrement traitée
+    bool isStreamFinished() const;
+
+    // Définit les paramètres du traitement (-1 pour laisser inchangé)
+    void setParameters(float delayMs = -1.0f, float gain = -1.0f,
+                       float lowFreq = -1.0f, float highFreq = -1.0f,
+                       FilterType filterType = BANDPASS);
+
+    // Mode d'annulation et paramètres du mode tonal
+    bool setEngineMode(EngineMode mode);
+    EngineMode getEngineMode() const { return static_cast<EngineMode>(engineMode.load()); }
+    void setTonalParameters(float fundamentalHz, unsigned int harmonics, float stepSize = 0.0f);
+    float getTrackedFrequency() const { return tonal.getTrackedFrequency(); }
+    HybridController::Status getHybridStatus() const { return hybrid.getStatus(); }
+
+    // Calibration automatique, retourne {délai, gain}
+    std::pair<float, float> calibrate();
+
+    // Récupère les données pour visualisation
+    void getVisualizationData(std::vector<float>& inputSignal, std::vector<float>& outputSignal);
+    size_t getVisualizationData(float* inputSignal, float* outputSignal, size_t capacity);
+
+    // Active / désactive la visualisation et la mesure de niveau
+    void setVisualizationEnabled(bool enabled);
+    void setMeteringEnabled(bool enabled);
+
+    // Niveaux de sortie du dernier bloc (mesure activée uniquement)
+    float getOutputPeak() const { return outputPeak.load(std::memory_order_relaxed); }
+    float getOutputRms() const { return outputRms.load(std::memory_order_relaxed); }
+
+    // Simulation hors ligne sans périphérique (blocs de bruit synthétique)
+    bool runSimulation(unsigned int blocks);
+
+    // Allocations sur le tas (tous threads) pendant la dernière simulation,
+    // comptées en mode d'audit temps réel uniquement
+    size_t getSimulationAllocations() const { return simulationAllocations; }
+
+    // Comparaison des chaînes large bande flottante et virgule fixe sur le
+    // même bruit synthétique, pour chaque type de filtre (flux arrêté)
+    struct FixedPointComparison {
+        FilterType filterType;
+        double exactRatio;          // Sorties identiques à la sortie flottante quantifiée Q15
+        double maxErrorLsb;         // Écart maximal, en pas de quantification Q15
+        double noiseFloorDb;        // Puissance de l'écart à la sortie flottante (dBFS)
+        double floatNsPerFrame;
+        double fixedNsPerFrame;
+    };
+    std::vector<FixedPointComparison> compareFixedPoint(unsigned int blocks);
+
+    // Hébergement (ZoneHost, interface C) : le moteur traite les blocs que l'hôte
+    // lui confie, sans flux ni thread de surveillance propres.
+    // outputChannels : 1 ou 2 ; inputChannels : 2 pour le mode hybride.
+    bool prepareHosted(unsigned int rate, unsigned int frames,
+                       unsigned int inputChannels, unsigned int outputChannels);
+    void processHosted(float* outputBuffer, const float* inputBuffer, unsigned int nFrames);
+    // Oubli de l'historique du signal (ligne de retard, filtre, états tonal et
+    // hybride) entre deux blocs, traitement suspendu par l'hôte ; les poids
+    // hybrides appris sont conservés, comme à la réouverture d'un flux
+    void resetHosted();
+    void releaseHosted();
+
+    // Adaptation automatique de la taille du tampon (backends temps réel)
+    void setAdaptiveBufferSize(bool enabled, unsigned int minFrames = 32, unsigned int maxFrames = 2048);
+    unsigned int getBufferFrames() const { return bufferFrames; }
+    unsigned int getSampleRate() const { return sampleRate; }
+
+    // Taille de tampon demandée au prochain démarrage
+    void setBufferFrames(unsigned int frames) {
+        if (!running) {
+            bufferFrames = frames;
+            profileFrames = frames;
         }
     }
-}
\ No newline at end of file
+
+    // Surveillance du flux : un callback absent plus de quelques périodes
+    // (blocage) ou un flux interrompu par le backend (périphérique perdu)
+    // déclenche la réouverture du flux, bornée à recoveryTimeoutMs
+    struct WatchdogStats {
+        uint64_t stalls = 0;            // Callbacks interrompus sur un flux actif
+        uint64_t deviceLosses = 0;      // Flux arrêtés par le backend
+        uint64_t recoveries = 0;        // Reprises confirmées par un callback
+        uint64_t failedRecoveries = 0;  // Reprises abandonnées après recoveryTimeoutMs
+        double lastRecoveryMs = 0.0;    // Du dernier callback avant la panne au premier après
+        double maxRecoveryMs = 0.0;
+        double totalRecoveryMs = 0.0;
+    };
+    WatchdogStats getWatchdogStats() const;
+
+    // Notifications (données visualisées, niveaux, xruns, paramètres
+    // appliqués) : descripteur à surveiller par abonné, hors thread audio
+    EventChannel& getEventChannel() { return events; }
+
+    // Fonction appelée par le thread du canal d'événements, au plus une fois
+    // par cycle de distribution (et non plus à chaque bloc, sur le thread audio)
+    void setUpdateCallback(std::function<void()> callback);
+
+    // Accesseurs
+    bool isRunning() const { return running; }
+    float getLatency() const { return measuredLatency; }
+    FilterType getCurrentFilterType() const { return currentFilterType; }
+
+private:
+    // Callback audio statique appelé par le backend
+    static int audioCallback(float* outputBuffer, const float* inputBuffer,
+                             unsigned int nFrames, double streamTime,
+                             unsigned int status, void* userData);
+
+    // Traitement audio interne
+    int processAudio(float* outputBuffer, const float* inputBuffer, unsigned int nFrames);
+    void processBroadband(float* outputBuffer, const float* inputBuffer, unsigned int nFrames);
+#ifdef NOISE_INVERTER_FIXED_POINT
+    void processBroadbandFixed(float* outputBuffer, const float* inputBuffer, unsigned int nFrames);
+#endif
+    void processTonal(float* outputBuffer, const float* inputBuffer, unsigned int nFrames);
+    void processMono(float* outputBuffer, const float* inputBuffer, unsigned int nFrames);
+    void captureOutput(const float* outputBuffer, const float* inputBuffer,
+                       unsigned int inputStride, unsigned int nFrames);
+
+    // Dispose les tampons dépendant de la fréquence d'échantillonnage dans
+    // l'arène, et verrouille celle-ci en mémoire au démarrage
+    void allocateBuffers();
+    void lockEngineState();
+
+    // Ouverture / réouverture du flux (streamMutex verrouillé pour openStream)
+    bool openStream();
+    bool restartStream(unsigned int newFrames);
+
+    // Cache des périphériques et profils
+    std::string knownDeviceName(int id) const;
+    int revalidateDevice(int id);
+    uint64_t currentProfileKey() const;
+    bool loadProfile();
+    CalibrationProfile currentProfile() const;
+    bool captureHybridState(CalibrationProfile& profile);
+    bool saveProfile();
+    bool saveHybridState();
+
+    // Fondu de sortie / d'entrée autour d'un redémarrage
+    void applyFade(float* outputBuffer, unsigned int nFrames);
+
+    // Filtre
+    void calculateFilterCoefficients();
+
+    // Choisit le noyau de traitement selon la configuration courante
+    void selectProcessingKernel();
+    static FilterTopology topologyFor(FilterType type);
+
+    // Thread de surveillance : charge CPU, taille du tampon, santé du flux
+    void monitorThread();
+    void stopMonitor();
+    bool monitorSleep(std::chrono::milliseconds duration);
+    std::chrono::milliseconds stallTimeout() const;
+    bool recoverStream(std::chrono::steady_clock::time_point lastCallback);
+
+    // Interface audio
+    std::unique_ptr<AudioBackend> backend;
+    StreamConfig streamConfig;
+    std::mutex streamMutex;
+    unsigned int sampleRate = 48000;
+    std::atomic<unsigned int> bufferFrames{128};
+    unsigned int outputChannels = 2;
+    std::atomic<bool> running{false};
+
+    // Paramètres du traitement
+    float delayMs = 0.0f;
+    float gain = 1.0f;
+    float lowFreq = 100.0f;
+    float highFreq = 2000.0f;
+    FilterType currentFilterType = BANDPASS;
+    float measuredLatency = 0.0f;
+
+    // Coefficients et états du filtre IIR
+    float b[3] = {0.0f, 0.0f, 0.0f};
+    float a[3] = {1.0f, 0.0f, 0.0f};
+    float filterState[4] = {0.0f, 0.0f, 0.0f, 0.0f};  // x[n-1], x[n-2], y[n-1], y[n-2]
+
+    // État du moteur (tampons de l'arène, pré-alloués et verrouillés)
+    EngineArena arena;
+    bool memoryLockWarned = false;
+    size_t simulationAllocations = 0;
+    static constexpr unsigned int referenceChunkFrames = 1024;
+
+    // Tampon de délai circulaire (seule la ligne de la chaîne compilée est réservée)
+    size_t delayBufferSize = 0;
+    size_t delayBufferPos = 0;
+#ifdef NOISE_INVERTER_FIXED_POINT
+    // Chaîne large bande en virgule fixe : ligne de retard Q15, états Q31
+    ArenaSpan<int16_t> delayBufferQ15;
+    int32_t filterStateQ31[5] = {0, 0, 0, 0, 0};  // ..., fraction conservée
+#else
+    ArenaSpan<float> delayBuffer;
+#endif
+
+    // Données de visualisation
+    static constexpr size_t vizBufferSize = 1024;
+    struct {
+        ArenaSpan<float> inputSignal;
+        ArenaSpan<float> outputSignal;
+        std::mutex mutex;
+    } vizData;
+
+    // Mode d'annulation (activeMode appartient au thread audio)
+    std::atomic<int> engineMode{BROADBAND};
+    EngineMode activeMode = BROADBAND;
+    TonalCanceller tonal;
+    HybridController hybrid;
+    ArenaSpan<float> referenceScratch;    // Voie de référence extraite d'une entrée multicanal
+
+    // Noyau de traitement actif et options associées
+    std::atomic<const KernelEntry*> activeKernel{nullptr};
+    std::atomic<bool> vizEnabled{true};
+    std::atomic<bool> meteringEnabled{false};
+    std::atomic<float> outputPeak{0.0f};
+    std::atomic<float> outputRms{0.0f};
+
+    // Profils de calibration et périphériques connus
+    ProfileStore profileStore;
+    std::vector<AudioDevice> knownDevices;
+    bool devicesFromCache = false;
+    bool profileLoading = true;
+    unsigned int profileFrames = 128;    // Taille de tampon configurée (clé des profils)
+    std::vector<float> secondaryPath;    // Modèle du chemin secondaire (profil)
+    std::vector<float> adaptiveWeights;  // Poids des filtres adaptatifs
+
+    // Adaptation de la taille du tampon
+    static constexpr unsigned int monitorWindowMs = 250;
+    std::atomic<bool> adaptiveBuffer{false};
+    BufferSizeController bufferController;
+    std::atomic<float> callbackLoadMax{0.0f};
+    std::atomic<unsigned int> xrunCount{0};
+
+    // Surveillance du flux (thread joint à l'arrêt). Le callback horodate
+    // chaque bloc ; le délai de blocage est un multiple de la période.
+    static constexpr unsigned int watchdogIntervalMs = 10;
+    static constexpr unsigned int stallPeriods = 8;
+    static constexpr unsigned int stallMinimumMs = 100;
+    static constexpr unsigned int recoveryTimeoutMs = 1000;
+    static constexpr unsigned int recoveryRetryMs = 20;
+    static constexpr unsigned int recoveryBackoffMs = 1000;
+    std::thread monitor;
+    mutable std::mutex monitorMutex;    // monitorStop, watchdogStats
+    std::condition_variable monitorWake;
+    bool monitorStop = false;
+    WatchdogStats watchdogStats;
+    std::atomic<int64_t> lastCallbackNs{0};   // steady_clock
+
+    // Fondus (l'état du fondu appartient au thread audio). FADE_IN part du
+    // gain courant (après FADE_OUT) ; FADE_IN_FROM_ZERO repart du silence,
+    // pour un flux rouvert sans fondu de sortie (panne)
+    enum FadeRequest { FADE_NONE = 0, FADE_IN = 1, FADE_OUT = 2, FADE_IN_FROM_ZERO = 3 };
+    static constexpr float fadeDurationMs = 5.0f;
+    std::atomic<int> fadeRequest{FADE_NONE};
+    std::atomic<bool> fadeOutComplete{false};
+    float fadeGain = 1.0f;
+    float fadeStep = 0.0f;
+
+    // Événements pour l'interface : accumulés pendant le bloc (thread
+    // audio), publiés en fin de bloc
+    EventChannel events;
+    uint32_t blockEvents = 0;
+    std::atomic<unsigned int> parameterGeneration{0};
+    unsigned int appliedParameterGeneration = 0;
+};
@@ -0,0 +1,212 @@
+#include "NoiseInverterC.h"
+#include "NoiseInverter.h"
+#include "NullBackend.h"
+#include "RealtimeAudit.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <new>
+
+namespace {
+
+// Lissage de la charge moyenne (par bloc)
+constexpr float loadSmoothing = 0.05f;
+
+// Plages des paramètres
+constexpr float maxDelayMs = 50.0f;
+constexpr float minFrequencyHz = 1.0f;
+
+// Champ numérique ramené dans [low, high] ; NaN : valeur en vigueur
+bool clampField(float& value, float applied, float low, float high) {
+    if (std::isnan(value)) {
+        value = applied;
+        return false;
+    }
+    value = std::min(std::max(value, low), high);
+    return true;
+}
+
+// Ramène chaque champ dans sa plage, fréquences bornées à Nyquist, plutôt
+// que de refuser l'ensemble (un hôte peut proposer 20 kHz à 32 kHz). Les
+// champs inutilisables gardent leur valeur en vigueur ; false s'il y en a.
+bool clampParameters(ni_parameters& p, const ni_parameters& applied, unsigned int sampleRate) {
+    const float nyquist = 0.5f * static_cast<float>(sampleRate);
+    const float maxGain = std::numeric_limits<float>::max();
+    bool valid = clampField(p.delay_ms, applied.delay_ms, 0.0f, maxDelayMs);
+    valid &= clampField(p.gain, applied.gain, 0.0f, maxGain);
+    valid &= clampField(p.low_hz, applied.low_hz, minFrequencyHz, nyquist);
+    valid &= clampField(p.high_hz, applied.high_hz, minFrequencyHz, nyquist);
+    valid &= clampField(p.tonal_fundamental_hz, applied.tonal_fundamental_hz, 0.0f, nyquist);
+    if (p.filter_type < NI_FILTER_BANDPASS || p.filter_type > NI_FILTER_HIGHPASS) {
+        p.filter_type = applied.filter_type;
+        valid = false;
+    }
+    if (p.mode < NI_MODE_BROADBAND || p.mode > NI_MODE_HYBRID) {
+        p.mode = applied.mode;
+        valid = false;
+    }
+    return valid;
+}
+
+} // namespace
+
+struct ni_engine {
+    std::unique_ptr<NoiseInverter> engine;
+    ni_stream_config config;
+    ni_parameters applied;
+
+    // Statistiques (écrites par le thread de traitement)
+    std::atomic<uint64_t> blocks{0};
+    std::atomic<uint64_t> frames{0};
+    std::atomic<float> averageLoad{0.0f};
+    std::atomic<float> maxLoad{0.0f};
+};
+
+extern "C" {
+
+void ni_default_parameters(ni_parameters* parameters) {
+    if (!parameters) {
+        return;
+    }
+    parameters->delay_ms = 0.0f;
+    parameters->gain = 1.0f;
+    parameters->low_hz = 100.0f;
+    parameters->high_hz = 2000.0f;
+    parameters->filter_type = NI_FILTER_BANDPASS;
+    parameters->mode = NI_MODE_BROADBAND;
+    parameters->tonal_fundamental_hz = 50.0f;
+    parameters->tonal_harmonics = 8;
+}
+
+ni_engine* ni_create(const ni_stream_config* config) {
+    if (!config || config->sample_rate == 0 || config->block_frames == 0 ||
+        config->input_channels < 1 || config->input_channels > 2 ||
+        config->output_channels < 1 || config->output_channels > 2) {
+        return nullptr;
+    }
+
+    ni_engine* handle = new (std::nothrow) ni_engine;
+    if (!handle) {
+        return nullptr;
+    }
+    try {
+        handle->config = *config;
+        handle->engine = std::make_unique<NoiseInverter>(std::make_unique<NullBackend>());
+        handle->engine->setProfileLoading(false);
+        handle->engine->setVisualizationEnabled(false);
+        handle->engine->setMeteringEnabled(true);
+        if (!handle->engine->prepareHosted(config->sample_rate, config->block_frames,
+                                           config->input_channels, config->output_channels)) {
+            delete handle;
+            return nullptr;
+        }
+    } catch (const std::exception&) {
+        delete handle;
+        return nullptr;
+    }
+
+    ni_default_parameters(&handle->applied);
+    return handle;
+}
+
+void ni_destroy(ni_engine* engine) {
+    if (!engine) {
+        return;
+    }
+    engine->engine->releaseHosted();
+    delete engine;
+}
+
+int ni_configure(ni_engine* engine, const ni_parameters* parameters) {
+    if (!engine || !parameters) {
+        return NI_ERROR_INVALID_ARGUMENT;
+    }
+    ni_parameters& applied = engine->applied;
+    ni_parameters p = *parameters;
+    int result = clampParameters(p, applied, engine->config.sample_rate) ? NI_OK : NI_ERROR_INVALID_ARGUMENT;
+    if (p.mode == NI_MODE_HYBRID && engine->config.input_channels < 2) {
+        p.mode = applied.mode;
+        result = NI_ERROR_UNSUPPORTED;
+    }
+
+    // -1 : valeur inchangée pour NoiseInverter::setParameters
+    if (p.delay_ms != applied.delay_ms || p.gain != applied.gain || p.low_hz != applied.low_hz ||
+        p.high_hz != applied.high_hz || p.filter_type != applied.filter_type) {
+        engine->engine->setParameters(p.delay_ms != applied.delay_ms ? p.delay_ms : -1.0f,
+                                      p.gain != applied.gain ? p.gain : -1.0f,
+                                      p.low_hz != applied.low_hz ? p.low_hz : -1.0f,
+                                      p.high_hz != applied.high_hz ? p.high_hz : -1.0f,
+                                      static_cast<NoiseInverter::FilterType>(p.filter_type));
+    }
+    if (p.tonal_fundamental_hz != applied.tonal_fundamental_hz || p.tonal_harmonics != applied.tonal_harmonics) {
+        engine->engine->setTonalParameters(p.tonal_fundamental_hz, p.tonal_harmonics);
+    }
+    if (p.mode != applied.mode) {
+        engine->engine->setEngineMode(static_cast<NoiseInverter::EngineMode>(p.mode));
+    }
+    applied = p;
+    return result;
+}
+
+void ni_reset(ni_engine* engine) {
+    if (!engine) {
+        return;
+    }
+    engine->engine->resetHosted();
+    engine->blocks.store(0, std::memory_order_relaxed);
+    engine->frames.store(0, std::memory_order_relaxed);
+    engine->averageLoad.store(0.0f, std::memory_order_relaxed);
+    engine->maxLoad.store(0.0f, std::memory_order_relaxed);
+}
+
+int ni_process(ni_engine* engine, float* output, const float* input, unsigned int frames) {
+    NI_RT_SECTION();
+    if (!engine || !output || !input) {
+        return NI_ERROR_INVALID_ARGUMENT;
+    }
+    if (frames == 0) {
+        return NI_OK;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    engine->engine->processHosted(output, input, frames);
+    float elapsed = std::chrono::duration<float>(std::chrono::steady_clock::now() - begin).count();
+
+    // Charge du bloc (durée / période)
+    float load = elapsed * engine->config.sample_rate / frames;
+    float average = engine->averageLoad.load(std::memory_order_relaxed);
+    average = (engine->blocks.load(std::memory_order_relaxed) == 0) ? load : average + loadSmoothing * (load - average);
+    engine->averageLoad.store(average, std::memory_order_relaxed);
+    if (load > engine->maxLoad.load(std::memory_order_relaxed)) {
+        engine->maxLoad.store(load, std::memory_order_relaxed);
+    }
+    engine->blocks.fetch_add(1, std::memory_order_relaxed);
+    engine->frames.fetch_add(frames, std::memory_order_relaxed);
+    return NI_OK;
+}
+
+void ni_get_stats(ni_engine* engine, ni_stats* stats) {
+    if (!engine || !stats) {
+        return;
+    }
+    stats->blocks = engine->blocks.load(std::memory_order_relaxed);
+    stats->frames = engine->frames.load(std::memory_order_relaxed);
+    stats->average_load = engine->averageLoad.load(std::memory_order_relaxed);
+    stats->max_load = engine->maxLoad.exchange(0.0f, std::memory_order_relaxed);
+    stats->output_peak = engine->engine->getOutputPeak();
+    stats->output_rms = engine->engine->getOutputRms();
+    stats->tracked_frequency_hz = engine->engine->getTrackedFrequency();
+    stats->hybrid_attenuation_db = engine->engine->getHybridStatus().attenuationDb;
+}
+
+const char* ni_version(void) {
+#ifdef NOISE_INVERTER_VERSION
+    return NOISE_INVERTER_VERSION;
+#else
+    return "1.0";
+#endif
+}
+
+} // extern "C"
@@ -0,0 +1,118 @@
+#ifndef NOISE_INVERTER_C_H
+#define NOISE_INVERTER_C_H
+
+/*
+ * Interface C de la bibliothèque noise_inverter_core : le moteur traite les
+ * blocs que lui confie un hôte (greffon, application), sans périphérique ni
+ * thread de surveillance propres.
+ *
+ * Threads :
+ *   - ni_create / ni_destroy : hors du thread audio (allocations, threads) ;
+ *   - ni_reset : hors du thread audio, aucun bloc en cours (activation) ;
+ *   - ni_configure / ni_process : thread de traitement, entre deux blocs ;
+ *     ni allocation, ni verrou, ni appel système ;
+ *   - ni_get_stats : n'importe quel thread.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(NOISE_INVERTER_CORE_SHARED)
+#  ifdef NOISE_INVERTER_CORE_BUILD
+#    define NI_API __declspec(dllexport)
+#  else
+#    define NI_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define NI_API __attribute__((visibility("default")))
+#else
+#  define NI_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct ni_engine ni_engine;
+
+/* Codes de retour */
+enum {
+    NI_OK = 0,
+    NI_ERROR_INVALID_ARGUMENT = -1,
+    NI_ERROR_UNSUPPORTED = -2       /* Mode hybride sans micro d'erreur */
+};
+
+/* Valeurs de NoiseInverter::FilterType et NoiseInverter::EngineMode */
+enum {
+    NI_FILTER_BANDPASS = 0,
+    NI_FILTER_LOWPASS = 1,
+    NI_FILTER_HIGHPASS = 2
+};
+
+enum {
+    NI_MODE_BROADBAND = 0,
+    NI_MODE_TONAL = 1,
+    NI_MODE_HYBRID = 2
+};
+
+/* Format du flux, fixé à la création. Échantillons réels entrelacés. */
+typedef struct {
+    unsigned int sample_rate;
+    unsigned int block_frames;      /* Taille nominale des blocs (latence estimée) */
+    unsigned int input_channels;    /* 1, ou 2 : micro d'erreur sur l'entrée 2 (hybride) */
+    unsigned int output_channels;   /* 1 ou 2 (même signal sur les deux voies) */
+} ni_stream_config;
+
+/* Hors plage, chaque champ est ramené dans la sienne (fréquences bornées à
+ * Nyquist) ; un champ non numérique ou inconnu garde sa valeur en vigueur */
+typedef struct {
+    float delay_ms;                 /* 0 à 50 ms */
+    float gain;
+    float low_hz;                   /* Fréquence de coupure du passe-haut */
+    float high_hz;                  /* Fréquence de coupure du passe-bas */
+    int filter_type;                /* NI_FILTER_* */
+    int mode;                       /* NI_MODE_* */
+    float tonal_fundamental_hz;     /* Mode tonal : fondamental initial */
+    unsigned int tonal_harmonics;
+} ni_parameters;
+
+typedef struct {
+    uint64_t blocks;
+    uint64_t frames;
+    float average_load;             /* Durée de traitement / durée du bloc (moyenne lissée) */
+    float max_load;                 /* Maximum depuis le précédent ni_get_stats */
+    float output_peak;              /* Dernier bloc */
+    float output_rms;
+    float tracked_frequency_hz;     /* Mode tonal */
+    float hybrid_attenuation_db;    /* Mode hybride */
+} ni_stats;
+
+/* Paramètres par défaut du moteur */
+NI_API void ni_default_parameters(ni_parameters* parameters);
+
+/* Crée un moteur prêt à traiter (paramètres par défaut) ; NULL en cas d'échec */
+NI_API ni_engine* ni_create(const ni_stream_config* config);
+NI_API void ni_destroy(ni_engine* engine);
+
+/* Applique les paramètres ; seuls ceux qui ont changé sont transmis au
+ * moteur (un changement de filtre réinitialise son état). Un champ ignoré
+ * (NaN, type ou mode inconnu, mode hybride sans micro d'erreur) n'empêche
+ * pas l'application des autres, mais est signalé par le code de retour. */
+NI_API int ni_configure(ni_engine* engine, const ni_parameters* parameters);
+
+/* Oubli de l'historique du signal (ligne de retard, filtre, états tonal et
+ * hybride) et des statistiques, avant une reprise du traitement ; les
+ * paramètres sont conservés */
+NI_API void ni_reset(ni_engine* engine);
+
+/* Traite un bloc de n trames ; output et input ne doivent pas se recouvrir */
+NI_API int ni_process(ni_engine* engine, float* output, const float* input, unsigned int frames);
+
+NI_API void ni_get_stats(ni_engine* engine, ni_stats* stats);
+
+NI_API const char* ni_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NOISE_INVERTER_C_H */
@@ -0,0 +1,140 @@
+/*
+ * Greffon LV2 (mono) construit sur l'interface C de noise_inverter_core.
+ * Les ports de contrôle sont relus à chaque bloc ; seuls les changements
+ * sont transmis au moteur (ni_configure, sans allocation). L'activation
+ * remet l'état du traitement à zéro (ni_reset).
+ */
+
+#include "NoiseInverterC.h"
+#include <lv2/core/lv2.h>
+#include <stdlib.h>
+
+#define NOISE_INVERTER_URI "urn:noise-inverter:mono"
+
+/* Taille nominale des blocs : les hôtes LV2 peuvent en envoyer de toute taille */
+#define NOISE_INVERTER_BLOCK_FRAMES 256
+
+typedef enum {
+    PORT_INPUT = 0,
+    PORT_OUTPUT = 1,
+    PORT_DELAY = 2,
+    PORT_GAIN = 3,
+    PORT_LOW_FREQ = 4,
+    PORT_HIGH_FREQ = 5,
+    PORT_FILTER = 6,
+    PORT_MODE = 7,
+    PORT_FUNDAMENTAL = 8,
+    PORT_HARMONICS = 9,
+    PORT_LOAD = 10,
+    PORT_COUNT
+} PortIndex;
+
+typedef struct {
+    ni_engine* engine;
+    ni_parameters parameters;
+    const float* input;
+    float* output;
+    const float* controls[PORT_COUNT];
+    float* load;
+} NoiseInverterPlugin;
+
+static LV2_Handle instantiate(const LV2_Descriptor* descriptor, double rate,
+                              const char* bundlePath, const LV2_Feature* const* features) {
+    (void)descriptor;
+    (void)bundlePath;
+    (void)features;
+
+    NoiseInverterPlugin* plugin = (NoiseInverterPlugin*)calloc(1, sizeof(NoiseInverterPlugin));
+    if (!plugin) {
+        return NULL;
+    }
+
+    ni_stream_config config;
+    config.sample_rate = (unsigned int)rate;
+    config.block_frames = NOISE_INVERTER_BLOCK_FRAMES;
+    config.input_channels = 1;
+    config.output_channels = 1;
+    plugin->engine = ni_create(&config);
+    if (!plugin->engine) {
+        free(plugin);
+        return NULL;
+    }
+    ni_default_parameters(&plugin->parameters);
+    return (LV2_Handle)plugin;
+}
+
+static void connect_port(LV2_Handle instance, uint32_t port, void* data) {
+    NoiseInverterPlugin* plugin = (NoiseInverterPlugin*)instance;
+    switch ((PortIndex)port) {
+        case PORT_INPUT:
+            plugin->input = (const float*)data;
+            break;
+        case PORT_OUTPUT:
+            plugin->output = (float*)data;
+            break;
+        case PORT_LOAD:
+            plugin->load = (float*)data;
+            break;
+        default:
+            if (port < PORT_COUNT) {
+                plugin->controls[port] = (const float*)data;
+            }
+            break;
+    }
+}
+
+static void activate(LV2_Handle instance) {
+    NoiseInverterPlugin* plugin = (NoiseInverterPlugin*)instance;
+    ni_reset(plugin->engine);
+}
+
+static float control(const NoiseInverterPlugin* plugin, PortIndex port, float fallback) {
+    return plugin->controls[port] ? *plugin->controls[port] : fallback;
+}
+
+static void run(LV2_Handle instance, uint32_t frames) {
+    NoiseInverterPlugin* plugin = (NoiseInverterPlugin*)instance;
+    ni_parameters next = plugin->parameters;
+    next.delay_ms = control(plugin, PORT_DELAY, next.delay_ms);
+    next.gain = control(plugin, PORT_GAIN, next.gain);
+    next.low_hz = control(plugin, PORT_LOW_FREQ, next.low_hz);
+    next.high_hz = control(plugin, PORT_HIGH_FREQ, next.high_hz);
+    next.filter_type = (int)control(plugin, PORT_FILTER, (float)next.filter_type);
+    next.mode = (int)control(plugin, PORT_MODE, (float)next.mode);
+    next.tonal_fundamental_hz = control(plugin, PORT_FUNDAMENTAL, next.tonal_fundamental_hz);
+    next.tonal_harmonics = (unsigned int)control(plugin, PORT_HARMONICS, (float)next.tonal_harmonics);
+
+    /* Valeurs hors plage (fréquences au-delà de Nyquist à 32 kHz et moins) :
+     * ramenées dans leur plage par ni_configure, champ par champ */
+    ni_configure(plugin->engine, &next);
+    plugin->parameters = next;
+
+    ni_process(plugin->engine, plugin->output, plugin->input, frames);
+
+    if (plugin->load) {
+        ni_stats stats;
+        ni_get_stats(plugin->engine, &stats);
+        *plugin->load = stats.average_load * 100.0f;
+    }
+}
+
+static void cleanup(LV2_Handle instance) {
+    NoiseInverterPlugin* plugin = (NoiseInverterPlugin*)instance;
+    ni_destroy(plugin->engine);
+    free(plugin);
+}
+
+static const LV2_Descriptor descriptor = {
+    NOISE_INVERTER_URI,
+    instantiate,
+    connect_port,
+    activate,
+    run,
+    NULL,   /* deactivate */
+    cleanup,
+    NULL    /* extension_data */
+};
+
+LV2_SYMBOL_EXPORT const LV2_Descriptor* lv2_descriptor(uint32_t index) {
+    return index == 0 ? &descriptor : NULL;
+}
@@ -0,0 +1,205 @@
+#include "NullBackend.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#ifdef __linux__
+#include <cerrno>
+#include <time.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Attente jusqu'à une échéance absolue
+void sleepUntil(Clock::time_point deadline) {
+#ifdef __linux__
+    // steady_clock correspond à CLOCK_MONOTONIC sous Linux
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+}
+
+// RMS des trames [first, last) d'un bloc entrelacé
+double blockRms(const std::vector<float>& buffer, unsigned int channels, unsigned int first, unsigned int last) {
+    double sum = 0.0;
+    for (size_t i = size_t(first) * channels; i < size_t(last) * channels; i++) {
+        sum += double(buffer[i]) * buffer[i];
+    }
+    return last > first ? std::sqrt(sum / (double(last - first) * channels)) : 0.0;
+}
+
+} // namespace
+
+NullBackend::NullBackend(Signal signal, bool clocked, uint64_t maxBlocks)
+    : signal(signal), clocked(clocked), maxBlocks(maxBlocks) {
+}
+
+NullBackend::~NullBackend() {
+    stop();
+}
+
+std::vector<AudioDevice> NullBackend::listDevices() {
+    AudioDevice input;
+    input.id = 0;
+    input.name = "null";
+    input.isInput = true;
+    input.isOutput = false;
+    input.isDefault = true;
+    input.maxChannels = 32;
+
+    AudioDevice output = input;
+    output.id = 1000;
+    output.isInput = false;
+    output.isOutput = true;
+
+    return {input, output};
+}
+
+bool NullBackend::open(StreamConfig& streamConfig, AudioProcessCallback processCallback, void* userData) {
+    // Périphérique encore absent après une perte simulée
+    unsigned int failures = openFailures.load();
+    while (failures > 0 && !openFailures.compare_exchange_weak(failures, failures - 1)) {
+    }
+    if (failures > 0) {
+        return false;
+    }
+
+    config = streamConfig;
+    callback = processCallback;
+    callbackUserData = userData;
+
+    inputBuffer.assign(config.bufferFrames * config.inputChannels, 0.0f);
+    outputBuffer.assign(config.bufferFrames * config.outputChannels, 0.0f);
+    finished = false;
+    return true;
+}
+
+bool NullBackend::start() {
+    if (running) {
+        return true;
+    }
+    running = true;
+    thread = std::thread(&NullBackend::clockThread, this);
+    return true;
+}
+
+void NullBackend::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+NullBackend::Stats NullBackend::getStats() const {
+    Stats stats;
+    stats.callbacks = callbackCount.load(std::memory_order_relaxed);
+    stats.lateCallbacks = lateCallbackCount.load(std::memory_order_relaxed);
+    stats.maxLatenessUs = maxLatenessUs.load(std::memory_order_relaxed);
+    stats.maxCallbackUs = maxCallbackUs.load(std::memory_order_relaxed);
+    stats.totalCallbackUs = totalCallbackUs.load(std::memory_order_relaxed);
+    stats.startHeadRms = startHeadRms.load(std::memory_order_relaxed);
+    stats.startTailRms = startTailRms.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void NullBackend::clockThread() {
+    const unsigned int nFrames = config.bufferFrames;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(nFrames) /
+                                      (config.sampleRate * (1.0 + clockSkewPpm * 1e-6))));
+    const double phaseStep = 2.0 * M_PI * 440.0 / config.sampleRate;
+
+    auto deadline = Clock::now();
+    uint64_t block = 0;
+    trace::setThreadName("audio (null)");
+
+    // maxBlocks porte sur le total, y compris avant une réouverture
+    while (running && (maxBlocks == 0 || callbackCount.load(std::memory_order_relaxed) < maxBlocks)) {
+        // Pannes simulées : le flux s'interrompt sans se terminer, ou le
+        // callback reste bloqué (interruptible par stop)
+        if (deviceLost.exchange(false)) {
+            running = false;
+            return;
+        }
+        unsigned int stall = stallMs.exchange(0);
+        if (stall > 0) {
+            NI_TRACE_INSTANT("blocage simulé", stall);
+            auto resume = Clock::now() + std::chrono::milliseconds(stall);
+            while (running && Clock::now() < resume) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            // Le pilote repart sur sa propre horloge, sans rattraper les blocs perdus
+            deadline = Clock::now();
+            continue;
+        }
+
+        // Générer le signal d'entrée
+        if (signal == NOISE) {
+            for (float& sample : inputBuffer) {
+                noiseState = noiseState * 1664525u + 1013904223u;
+                sample = (static_cast<int32_t>(noiseState) / 2147483648.0f) * 0.5f;
+            }
+        } else if (signal == SINE) {
+            for (unsigned int i = 0; i < nFrames; i++) {
+                float value = 0.5f * static_cast<float>(std::sin(phase));
+                phase += phaseStep;
+                for (unsigned int c = 0; c < config.inputChannels; c++) {
+                    inputBuffer[i * config.inputChannels + c] = value;
+                }
+            }
+            phase = std::fmod(phase, 2.0 * M_PI);
+        }
+
+        // Un réveil en retard de plus d'une période équivaut à un xrun
+        auto begin = Clock::now();
+        unsigned int status = STREAM_OK;
+        if (clocked) {
+            double lateness = std::chrono::duration<double, std::micro>(begin - deadline).count();
+            if (lateness > maxLatenessUs.load(std::memory_order_relaxed)) {
+                maxLatenessUs.store(lateness, std::memory_order_relaxed);
+            }
+            if (begin - deadline > period) {
+                lateCallbackCount.fetch_add(1, std::memory_order_relaxed);
+                status = STREAM_OUTPUT_UNDERFLOW;
+            }
+        }
+
+        double streamTime = static_cast<double>(block * nFrames) / config.sampleRate;
+        callback(outputBuffer.data(), inputBuffer.data(), nFrames, streamTime, status, callbackUserData);
+
+        double duration = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+        if (duration > maxCallbackUs.load(std::memory_order_relaxed)) {
+            maxCallbackUs.store(duration, std::memory_order_relaxed);
+        }
+        totalCallbackUs.store(totalCallbackUs.load(std::memory_order_relaxed) + duration, std::memory_order_relaxed);
+        callbackCount.fetch_add(1, std::memory_order_relaxed);
+        if (block == 0) {
+            const unsigned int quarter = nFrames / 4;
+            startHeadRms.store(blockRms(outputBuffer, config.outputChannels, 0, quarter), std::memory_order_relaxed);
+            startTailRms.store(blockRms(outputBuffer, config.outputChannels, nFrames - quarter, nFrames),
+                               std::memory_order_relaxed);
+        }
+        block++;
+
+        if (clocked) {
+            deadline += period;
+            sleepUntil(deadline);
+        }
+    }
+
+    finished = true;
+    running = false;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Backend sans périphérique : produit des callbacks cadencés par une horloge
+// précise (échéances absolues), avec un signal d'entrée synthétique.
+// La sortie est ignorée. Permet des mesures de latence et de débit
+// reproductibles sur une machine sans carte son.
+class NullBackend : public AudioBackend {
+public:
+    enum Signal {
+        SILENCE = 0,
+        NOISE = 1,
+        SINE = 2
+    };
+
+    // Statistiques de cadencement
+    struct Stats {
+        uint64_t callbacks = 0;
+        uint64_t lateCallbacks = 0;      // Réveils après l'échéance + 1 période
+        double maxLatenessUs = 0.0;      // Retard maximal au réveil
+        double maxCallbackUs = 0.0;      // Durée maximale d'un callback
+        double totalCallbackUs = 0.0;
+        // Sortie du premier bloc depuis le dernier démarrage (fondus) : RMS
+        // du premier et du dernier quart du bloc
+        double startHeadRms = 0.0;
+        double startTailRms = 0.0;
+    };
+
+    // clocked = false : les blocs s'enchaînent sans attente (mesure de débit)
+    // maxBlocks = 0 : infini
+    explicit NullBackend(Signal signal = NOISE, bool clocked = true, uint64_t maxBlocks = 0);
+    ~NullBackend() override;
+
+    const char* name() const override { return "null"; }
+
+    std::vector<AudioDevice> listDevices() override;
+
+    bool open(StreamConfig& config, AudioProcessCallback callback, void* userData) override;
+    bool start() override;
+    void stop() override;
+    void close() override {}
+
+    bool isRunning() const override { return running; }
+    bool isFinished() const override { return finished; }
+    bool isRealtime() const override { return clocked; }
+
+    // Écart de l'horloge simulée à la fréquence nominale (ppm, positif :
+    // plus rapide), pour reproduire deux périphériques qui dérivent
+    void setClockSkew(double ppm) { clockSkewPpm = ppm; }
+
+    // Injection de pannes, pour vérifier la surveillance du flux :
+    // blocage du callback pendant durationMs (pilote figé), puis reprise
+    void injectStall(unsigned int durationMs) { stallMs = durationMs; }
+
+    // Perte du périphérique : le flux s'interrompt sans être terminé, et les
+    // failedOpens ouvertures suivantes échouent (périphérique absent)
+    void injectDeviceLoss(unsigned int failedOpens = 0) {
+        openFailures = failedOpens;
+        deviceLost = true;
+    }
+
+    // Statistiques cumulées depuis la construction, lisibles depuis
+    // n'importe quel thread (en cours de flux, les champs peuvent provenir
+    // de blocs consécutifs différents)
+    Stats getStats() const;
+
+private:
+    void clockThread();
+
+    Signal signal;
+    bool clocked;
+    uint64_t maxBlocks;
+    double clockSkewPpm = 0.0;
+
+    StreamConfig config;
+    AudioProcessCallback callback = nullptr;
+    void* callbackUserData = nullptr;
+
+    std::vector<float> inputBuffer;
+    std::vector<float> outputBuffer;
+    uint32_t noiseState = 22222;
+    double phase = 0.0;
+
+    // Statistiques (écrites par le thread d'horloge seul)
+    std::atomic<uint64_t> callbackCount{0};
+    std::atomic<uint64_t> lateCallbackCount{0};
+    std::atomic<double> maxLatenessUs{0.0};
+    std::atomic<double> maxCallbackUs{0.0};
+    std::atomic<double> totalCallbackUs{0.0};
+    std::atomic<double> startHeadRms{0.0};
+    std::atomic<double> startTailRms{0.0};
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> finished{false};
+
+    // Pannes demandées (consommées par le thread d'horloge et open)
+    std::atomic<unsigned int> stallMs{0};
+    std::atomic<unsigned int> openFailures{0};
+    std::atomic<bool> deviceLost{false};
+};
@@ -0,0 +1,222 @@
+/*
+ * Pilote hors ligne de noise_inverter_core, en C : vérifie l'interface sans
+ * périphérique ni hôte.
+ *
+ *   noise_inverter_offline [blocs] [trames]
+ *       bruit synthétique traité dans chaque configuration (filtres, modes,
+ *       changements de paramètres en cours de flux) ; code de retour non nul
+ *       si une sortie n'est pas finie ou si un appel échoue.
+ *
+ *   noise_inverter_offline --pipe [trames] < entree.f32 > sortie.f32
+ *       flux mono float32 brut à 48 kHz, de l'entrée standard vers la sortie.
+ */
+
+#include "NoiseInverterC.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SAMPLE_RATE 48000
+
+static unsigned int noiseState = 12345u;
+
+static void fillNoise(float* buffer, unsigned int frames) {
+    unsigned int i;
+    for (i = 0; i < frames; i++) {
+        noiseState = noiseState * 1664525u + 1013904223u;
+        buffer[i] = ((float)(int)noiseState / 2147483648.0f) * 0.5f;
+    }
+}
+
+static int finiteBlock(const float* buffer, unsigned int count) {
+    unsigned int i;
+    for (i = 0; i < count; i++) {
+        if (!isfinite(buffer[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static ni_engine* createEngine(unsigned int frames, unsigned int inputChannels, unsigned int outputChannels) {
+    ni_stream_config config;
+    config.sample_rate = SAMPLE_RATE;
+    config.block_frames = frames;
+    config.input_channels = inputChannels;
+    config.output_channels = outputChannels;
+    return ni_create(&config);
+}
+
+/* Une configuration : blocs de bruit, paramètres modifiés à mi-parcours */
+static int runCase(const char* label, int mode, int filter, unsigned int outputChannels,
+                   unsigned int blocks, unsigned int frames, float* input, float* output) {
+    ni_parameters parameters;
+    ni_stats stats;
+    unsigned int block;
+    unsigned int i;
+    int failures = 0;
+
+    ni_engine* engine = createEngine(frames, 1, outputChannels);
+    if (!engine) {
+        printf("  %s : création impossible\n", label);
+        return 1;
+    }
+
+    ni_default_parameters(&parameters);
+    parameters.mode = mode;
+    parameters.filter_type = filter;
+    parameters.delay_ms = 2.0f;
+    parameters.gain = 0.9f;
+    if (ni_configure(engine, &parameters) != NI_OK) {
+        printf("  %s : paramètres refusés\n", label);
+        failures++;
+    }
+
+    for (block = 0; block < blocks; block++) {
+        if (block == blocks / 2) {
+            parameters.delay_ms = 5.0f;
+            parameters.high_hz = 1500.0f;
+            parameters.tonal_fundamental_hz = 60.0f;
+            if (ni_configure(engine, &parameters) != NI_OK) {
+                failures++;
+            }
+        }
+        fillNoise(input, frames);
+        if (ni_process(engine, output, input, frames) != NI_OK) {
+            failures++;
+        }
+        if (!finiteBlock(output, frames * outputChannels)) {
+            printf("  %s : sortie non finie au bloc %u\n", label, block);
+            failures++;
+            break;
+        }
+    }
+
+    ni_get_stats(engine, &stats);
+    printf("  %s : %llu blocs, charge moyenne %.3f %%, max %.3f %%, crête %.3f, rms %.3f\n", label,
+           (unsigned long long)stats.blocks, stats.average_load * 100.0, stats.max_load * 100.0,
+           stats.output_peak, stats.output_rms);
+    if (stats.blocks != blocks && failures == 0) {
+        failures++;
+    }
+
+    /* Après ni_reset, un bloc de silence ne rend que du silence */
+    ni_reset(engine);
+    memset(input, 0, frames * sizeof(float));
+    ni_process(engine, output, input, frames);
+    for (i = 0; i < frames * outputChannels; i++) {
+        if (output[i] != 0.0f) {
+            printf("  %s : état conservé après ni_reset\n", label);
+            failures++;
+            break;
+        }
+    }
+    ni_get_stats(engine, &stats);
+    if (stats.blocks != 1) {
+        printf("  %s : statistiques conservées après ni_reset\n", label);
+        failures++;
+    }
+    ni_destroy(engine);
+    return failures;
+}
+
+static int selfCheck(unsigned int blocks, unsigned int frames) {
+    static const char* filters[3] = {"passe-bande", "passe-bas", "passe-haut"};
+    ni_parameters parameters;
+    ni_engine* engine;
+    char label[64];
+    int failures = 0;
+    int filter;
+
+    float* input = (float*)calloc(frames, sizeof(float));
+    float* output = (float*)calloc((size_t)frames * 2, sizeof(float));
+    if (!input || !output) {
+        free(input);
+        free(output);
+        return 1;
+    }
+
+    printf("noise_inverter_core %s : %u blocs de %u trames\n", ni_version(), blocks, frames);
+    for (filter = NI_FILTER_BANDPASS; filter <= NI_FILTER_HIGHPASS; filter++) {
+        snprintf(label, sizeof(label), "large bande, %s, stéréo", filters[filter]);
+        failures += runCase(label, NI_MODE_BROADBAND, filter, 2, blocks, frames, input, output);
+    }
+    failures += runCase("large bande, passe-bande, mono", NI_MODE_BROADBAND, NI_FILTER_BANDPASS, 1,
+                        blocks, frames, input, output);
+    failures += runCase("tonal, mono", NI_MODE_TONAL, NI_FILTER_BANDPASS, 1, blocks, frames, input, output);
+
+    /* Refus attendus : mode hybride sans micro d'erreur, délai non numérique ;
+     * fréquence au-delà de Nyquist ramenée dans la plage */
+    engine = createEngine(frames, 1, 1);
+    if (engine) {
+        ni_default_parameters(&parameters);
+        parameters.mode = NI_MODE_HYBRID;
+        if (ni_configure(engine, &parameters) != NI_ERROR_UNSUPPORTED) {
+            printf("  mode hybride accepté sans micro d'erreur\n");
+            failures++;
+        }
+        ni_default_parameters(&parameters);
+        parameters.delay_ms = NAN;
+        if (ni_configure(engine, &parameters) != NI_ERROR_INVALID_ARGUMENT) {
+            printf("  délai non numérique accepté\n");
+            failures++;
+        }
+        ni_default_parameters(&parameters);
+        parameters.filter_type = NI_FILTER_LOWPASS;
+        parameters.high_hz = SAMPLE_RATE;
+        if (ni_configure(engine, &parameters) != NI_OK) {
+            printf("  fréquence au-delà de Nyquist refusée\n");
+            failures++;
+        }
+        fillNoise(input, frames);
+        if (ni_process(engine, output, input, frames) != NI_OK || !finiteBlock(output, frames)) {
+            printf("  sortie non finie, fréquence bornée à Nyquist\n");
+            failures++;
+        }
+        ni_destroy(engine);
+    } else {
+        failures++;
+    }
+
+    free(input);
+    free(output);
+    printf("%s (%d échec(s))\n", failures == 0 ? "Vérification réussie" : "Vérification échouée", failures);
+    return failures == 0 ? 0 : 1;
+}
+
+static int pipeStream(unsigned int frames) {
+    size_t count;
+    float* input = (float*)calloc(frames, sizeof(float));
+    float* output = (float*)calloc(frames, sizeof(float));
+    ni_engine* engine = createEngine(frames, 1, 1);
+    if (!input || !output || !engine) {
+        free(input);
+        free(output);
+        ni_destroy(engine);
+        return 1;
+    }
+
+    while ((count = fread(input, sizeof(float), frames, stdin)) > 0) {
+        ni_process(engine, output, input, (unsigned int)count);
+        if (fwrite(output, sizeof(float), count, stdout) != count) {
+            break;
+        }
+    }
+
+    ni_destroy(engine);
+    free(input);
+    free(output);
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && strcmp(argv[1], "--pipe") == 0) {
+        unsigned int frames = (argc >= 3) ? (unsigned int)strtoul(argv[2], NULL, 10) : 256;
+        return pipeStream(frames > 0 ? frames : 256);
+    }
+
+    unsigned int blocks = (argc >= 2) ? (unsigned int)strtoul(argv[1], NULL, 10) : 2000;
+    unsigned int frames = (argc >= 3) ? (unsigned int)strtoul(argv[2], NULL, 10) : 256;
+    return selfCheck(blocks, frames > 0 ? frames : 256);
+}
@@ -0,0 +1,187 @@
+#include "PipeBackend.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#define ni_read _read
+#define ni_write _write
+#define ni_dup _dup
+#define ni_dup2 _dup2
+#define ni_close _close
+#else
+#include <unistd.h>
+#define ni_read ::read
+#define ni_write ::write
+#define ni_dup ::dup
+#define ni_dup2 ::dup2
+#define ni_close ::close
+#endif
+
+// La redirection de la console se fait dès la construction, pour que les
+// messages émis avant l'ouverture du flux n'arrivent pas sur stdout
+PipeBackend::PipeBackend(SampleFormat format) : format(format) {
+#ifdef _WIN32
+    _setmode(0, _O_BINARY);
+    _setmode(1, _O_BINARY);
+#endif
+
+    // Garder stdout pour l'audio et rediriger la console vers stderr
+    std::cout.flush();
+    outputFd = ni_dup(1);
+    if (outputFd < 0 || ni_dup2(2, 1) < 0) {
+        std::cerr << "Erreur: impossible de rediriger stdout" << std::endl;
+    }
+}
+
+PipeBackend::~PipeBackend() {
+    stop();
+    close();
+
+    // Restaurer stdout
+    if (outputFd >= 0) {
+        std::cout.flush();
+        ni_dup2(outputFd, 1);
+        ni_close(outputFd);
+        outputFd = -1;
+    }
+}
+
+// Un seul "périphérique" : le couple stdin / stdout
+std::vector<AudioDevice> PipeBackend::listDevices() {
+    AudioDevice input;
+    input.id = 0;
+    input.name = "stdin";
+    input.isInput = true;
+    input.isOutput = false;
+    input.isDefault = true;
+    input.maxChannels = 32;
+
+    AudioDevice output = input;
+    output.id = 1000;
+    output.name = "stdout";
+    output.isInput = false;
+    output.isOutput = true;
+
+    return {input, output};
+}
+
+bool PipeBackend::open(StreamConfig& streamConfig, AudioProcessCallback processCallback, void* userData) {
+    config = streamConfig;
+    callback = processCallback;
+    callbackUserData = userData;
+
+    // Tampons préalloués pour un bloc
+    size_t sampleSize = (format == FLOAT32) ? sizeof(float) : sizeof(int16_t);
+    inputBuffer.assign(config.bufferFrames * config.inputChannels, 0.0f);
+    outputBuffer.assign(config.bufferFrames * config.outputChannels, 0.0f);
+    rawBuffer.assign(config.bufferFrames * std::max(config.inputChannels, config.outputChannels) * sampleSize, 0);
+
+    if (outputFd < 0) {
+        return false;
+    }
+
+    finished = false;
+    return true;
+}
+
+bool PipeBackend::start() {
+    if (running) {
+        return true;
+    }
+    running = true;
+    thread = std::thread(&PipeBackend::processThread, this);
+    return true;
+}
+
+void PipeBackend::stop() {
+    running = false;
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void PipeBackend::close() {
+}
+
+size_t PipeBackend::readFully(void* data, size_t bytes) {
+    uint8_t* dst = static_cast<uint8_t*>(data);
+    size_t done = 0;
+    while (done < bytes) {
+        auto count = ni_read(inputFd, dst + done, static_cast<unsigned int>(bytes - done));
+        if (count <= 0) {
+            break;
+        }
+        done += static_cast<size_t>(count);
+    }
+    return done;
+}
+
+bool PipeBackend::writeFully(const void* data, size_t bytes) {
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    size_t done = 0;
+    while (done < bytes) {
+        auto count = ni_write(outputFd, src + done, static_cast<unsigned int>(bytes - done));
+        if (count <= 0) {
+            return false;
+        }
+        done += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+// Boucle : lire un bloc, traiter, écrire, jusqu'à la fin de stdin
+void PipeBackend::processThread() {
+    const unsigned int nFrames = config.bufferFrames;
+    const size_t inSamples = nFrames * config.inputChannels;
+    const size_t outSamples = nFrames * config.outputChannels;
+    const size_t sampleSize = (format == FLOAT32) ? sizeof(float) : sizeof(int16_t);
+    uint64_t framesDone = 0;
+
+    while (running) {
+        size_t bytes = readFully(rawBuffer.data(), inSamples * sampleSize);
+        if (bytes == 0) {
+            break;
+        }
+
+        // Compléter un dernier bloc partiel par du silence
+        size_t samples = bytes / sampleSize;
+        if (format == FLOAT32) {
+            std::memcpy(inputBuffer.data(), rawBuffer.data(), samples * sizeof(float));
+        } else {
+            const int16_t* raw = reinterpret_cast<const int16_t*>(rawBuffer.data());
+            for (size_t i = 0; i < samples; i++) {
+                inputBuffer[i] = raw[i] / 32768.0f;
+            }
+        }
+        std::fill(inputBuffer.begin() + samples, inputBuffer.end(), 0.0f);
+
+        double streamTime = static_cast<double>(framesDone) / config.sampleRate;
+        callback(outputBuffer.data(), inputBuffer.data(), nFrames, streamTime, STREAM_OK, callbackUserData);
+        framesDone += nFrames;
+
+        // N'écrire que les trames correspondant à l'entrée reçue
+        size_t framesIn = samples / config.inputChannels;
+        size_t outCount = std::min(outSamples, framesIn * config.outputChannels);
+        bool ok;
+        if (format == FLOAT32) {
+            ok = writeFully(outputBuffer.data(), outCount * sizeof(float));
+        } else {
+            int16_t* raw = reinterpret_cast<int16_t*>(rawBuffer.data());
+            for (size_t i = 0; i < outCount; i++) {
+                float v = std::max(-1.0f, std::min(1.0f, outputBuffer[i]));
+                raw[i] = static_cast<int16_t>(v * 32767.0f);
+            }
+            ok = writeFully(raw, outCount * sizeof(int16_t));
+        }
+
+        if (!ok || bytes < inSamples * sampleSize) {
+            break;
+        }
+    }
+
+    finished = true;
+    running = false;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Backend PCM brut sur stdin / stdout, pour les pipelines shell et conteneurs.
+// Les échantillons sont entrelacés, en float 32 bits ou entier 16 bits
+// little-endian. Les messages console sont redirigés vers stderr tant que
+// le backend existe afin de ne pas corrompre le flux de sortie.
+class PipeBackend : public AudioBackend {
+public:
+    enum SampleFormat {
+        FLOAT32 = 0,
+        INT16 = 1
+    };
+
+    explicit PipeBackend(SampleFormat format = FLOAT32);
+    ~PipeBackend() override;
+
+    const char* name() const override { return "pipe"; }
+
+    std::vector<AudioDevice> listDevices() override;
+
+    bool open(StreamConfig& config, AudioProcessCallback callback, void* userData) override;
+    bool start() override;
+    void stop() override;
+    void close() override;
+
+    bool isRunning() const override { return running; }
+    bool isFinished() const override { return finished; }
+    bool isRealtime() const override { return false; }
+
+private:
+    void processThread();
+
+    // Lit / écrit exactement `bytes` octets (retourne le nombre transféré)
+    size_t readFully(void* data, size_t bytes);
+    bool writeFully(const void* data, size_t bytes);
+
+    SampleFormat format;
+    StreamConfig config;
+    AudioProcessCallback callback = nullptr;
+    void* callbackUserData = nullptr;
+
+    int inputFd = 0;
+    int outputFd = -1;   // Copie de stdout (stdout pointe ensuite vers stderr)
+
+    std::vector<float> inputBuffer;
+    std::vector<float> outputBuffer;
+    std::vector<uint8_t> rawBuffer;
+
+    std::thread thread;
+    std::atomic<bool> running{false};
+    std::atomic<bool> finished{false};
+};
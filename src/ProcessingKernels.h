@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+// Noyaux de traitement spécialisés à la compilation.
+//
+// Chaque combinaison (topologie du filtre, nombre de canaux de sortie,
+// visualisation, mesure de niveau) produit une boucle dédiée sans branche
+// par échantillon et sans multiplication par des coefficients nuls.
+// Le bloc est traité en deux étapes : la récurrence du filtre (séquentielle)
+// puis le mélange avec le signal retardé (vectorisable).
+// La sélection se fait une seule fois, lors d'un changement de paramètres,
+// via une table de dispatch.
+
+// Topologie effective du filtre (déduite du type de filtre)
+enum class FilterTopology {
+    ONE_POLE_LOWPASS = 0,   // y = b0*x - a1*y[-1]
+    ONE_POLE_HIGHPASS = 1,  // y = b0*x + b1*x[-1] - a1*y[-1]
+    BIQUAD_BANDPASS = 2     // y = b0*x + b2*x[-2] - a1*y[-1] - a2*y[-2]
+};
+
+// Contexte d'un bloc : copie locale de l'état du moteur
+struct KernelContext {
+    // Coefficients du filtre
+    float b0 = 0.0f, b1 = 0.0f, b2 = 0.0f;
+    float a1 = 0.0f, a2 = 0.0f;
+    // États du filtre (forme directe I)
+    float x1 = 0.0f, x2 = 0.0f;
+    float y1 = 0.0f, y2 = 0.0f;
+
+    // Gain déjà inversé (-gain)
+    float negGain = 0.0f;
+
+    // Ligne de retard
+    float* delayBuffer = nullptr;
+    size_t delayBufferSize = 0;
+    size_t writePos = 0;
+    size_t readPos = 0;
+
+    // Visualisation (un échantillon sur deux)
+    float* vizInput = nullptr;
+    float* vizOutput = nullptr;
+    size_t vizBufferSize = 0;
+
+    // Mesure de niveau de sortie
+    float peak = 0.0f;
+    float sumSquares = 0.0f;
+};
+
+using KernelFn = void (*)(KernelContext&, float*, const float*, unsigned int);
+
+struct KernelEntry {
+    KernelFn fn;
+    FilterTopology topology;
+    bool usesViz;
+    bool usesMeter;
+};
+
+namespace kernels {
+
+// Étape 1 : filtrer et inverser dans la ligne de retard.
+// Seule la récurrence du filtre reste séquentielle.
+// Forme directe I : la récurrence ne porte que sur y, ce qui réduit la
+// chaîne de dépendance à une seule multiplication-addition par échantillon.
+// Les coefficients et états sont copiés en variables locales pour que le
+// compilateur les garde en registres (pas d'aliasing avec dst).
+template <FilterTopology Topology>
+inline void filterIntoDelay(KernelContext& ctx, const float* in, unsigned int nFrames) {
+    const float b0 = ctx.b0, b1 = ctx.b1, b2 = ctx.b2;
+    const float a1 = ctx.a1, a2 = ctx.a2;
+    const float negGain = ctx.negGain;
+    float x1 = ctx.x1, x2 = ctx.x2, y1 = ctx.y1, y2 = ctx.y2;
+
+    unsigned int done = 0;
+    while (done < nFrames) {
+        unsigned int count = static_cast<unsigned int>(
+            std::min<size_t>(nFrames - done, ctx.delayBufferSize - ctx.writePos));
+        float* dst = ctx.delayBuffer + ctx.writePos;
+        const float* x = in + done;
+        for (unsigned int i = 0; i < count; i++) {
+            float y;
+            if constexpr (Topology == FilterTopology::ONE_POLE_LOWPASS) {
+                float feed = b0 * x[i];
+                y = feed - a1 * y1;
+            } else if constexpr (Topology == FilterTopology::ONE_POLE_HIGHPASS) {
+                y = (b0 * x[i] + b1 * x1) - a1 * y1;
+                x1 = x[i];
+            } else {
+                y = (b0 * x[i] + b2 * x2 - a2 * y2) - a1 * y1;
+                x2 = x1;
+                x1 = x[i];
+                y2 = y1;
+            }
+            y1 = y;
+            dst[i] = y * negGain;
+        }
+        done += count;
+        ctx.writePos += count;
+        if (ctx.writePos == ctx.delayBufferSize) {
+            ctx.writePos = 0;
+        }
+    }
+
+    ctx.x1 = x1;
+    ctx.x2 = x2;
+    ctx.y1 = y1;
+    ctx.y2 = y2;
+}
+
+// Étape 2 : lire le signal retardé, sommer, limiter et dupliquer sur les canaux.
+// Boucles contiguës sans dépendance, vectorisables par le compilateur.
+template <unsigned int OutChannels, bool WithMeter>
+inline void mixFromDelay(KernelContext& ctx, float* out, const float* in, unsigned int nFrames) {
+    unsigned int done = 0;
+    while (done < nFrames) {
+        unsigned int count = static_cast<unsigned int>(
+            std::min<size_t>(nFrames - done, ctx.delayBufferSize - ctx.readPos));
+        const float* src = ctx.delayBuffer + ctx.readPos;
+        const float* x = in + done;
+        float* dst = out + done * OutChannels;
+        for (unsigned int i = 0; i < count; i++) {
+            float output = std::max(-1.0f, std::min(1.0f, x[i] + src[i]));
+            for (unsigned int c = 0; c < OutChannels; c++) {
+                dst[i * OutChannels + c] = output;
+            }
+        }
+        if constexpr (WithMeter) {
+            float peak = ctx.peak;
+            float sumSquares = ctx.sumSquares;
+            for (unsigned int i = 0; i < count; i++) {
+                float output = dst[i * OutChannels];
+                peak = std::max(peak, std::abs(output));
+                sumSquares += output * output;
+            }
+            ctx.peak = peak;
+            ctx.sumSquares = sumSquares;
+        }
+        done += count;
+        ctx.readPos += count;
+        if (ctx.readPos == ctx.delayBufferSize) {
+            ctx.readPos = 0;
+        }
+    }
+}
+
+// Traite un bloc complet.
+// Contrainte : nFrames <= delayBufferSize - délai, afin que l'étape 1
+// n'écrase pas d'échantillons que l'étape 2 doit encore lire
+// (garanti par l'appelant, qui découpe le bloc si nécessaire).
+template <FilterTopology Topology, unsigned int OutChannels, bool WithViz, bool WithMeter>
+void processBlock(KernelContext& ctx, float* out, const float* in, unsigned int nFrames) {
+    filterIntoDelay<Topology>(ctx, in, nFrames);
+    mixFromDelay<OutChannels, WithMeter>(ctx, out, in, nFrames);
+
+    if constexpr (WithViz) {
+        // Un échantillon sur deux (indices pairs) alimente la visualisation
+        size_t vizPos = 0;
+        for (unsigned int i = 0; i < nFrames; i += 2) {
+            ctx.vizInput[vizPos] = in[i];
+            ctx.vizOutput[vizPos] = out[i * OutChannels];
+            vizPos = (vizPos + 1 == ctx.vizBufferSize) ? 0 : vizPos + 1;
+        }
+    }
+}
+
+} // namespace kernels
+
+// Sélectionne l'instanciation correspondant à la configuration.
+// outChannels est limité à 1 ou 2.
+inline const KernelEntry* selectKernel(FilterTopology topology, unsigned int outChannels,
+                                       bool withViz, bool withMeter) {
+    using namespace kernels;
+    using T = FilterTopology;
+
+#define NI_KERNEL(T_, C_, V_, M_) { &processBlock<T_, C_, V_, M_>, T_, V_, M_ }
+#define NI_KERNELS_FOR(T_) \
+    NI_KERNEL(T_, 1, false, false), NI_KERNEL(T_, 1, false, true), \
+    NI_KERNEL(T_, 1, true, false),  NI_KERNEL(T_, 1, true, true),  \
+    NI_KERNEL(T_, 2, false, false), NI_KERNEL(T_, 2, false, true), \
+    NI_KERNEL(T_, 2, true, false),  NI_KERNEL(T_, 2, true, true)
+
+    // Index : [topologie][canaux-1][viz][meter]
+    static const KernelEntry table[] = {
+        NI_KERNELS_FOR(T::ONE_POLE_LOWPASS),
+        NI_KERNELS_FOR(T::ONE_POLE_HIGHPASS),
+        NI_KERNELS_FOR(T::BIQUAD_BANDPASS)
+    };
+
+#undef NI_KERNELS_FOR
+#undef NI_KERNEL
+
+    unsigned int channelIndex = (outChannels >= 2) ? 1 : 0;
+    size_t index = static_cast<size_t>(topology) * 8
+                 + channelIndex * 4
+                 + (withViz ? 2 : 0)
+                 + (withMeter ? 1 : 0);
+    return &table[index];
+}
@@ -0,0 +1,353 @@
+#include "ProfileStore.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char profilesMagic[4] = {'N', 'I', 'P', 'F'};
+const char devicesMagic[4] = {'N', 'I', 'D', 'C'};
+const uint32_t formatVersion = 1;
+
+// Lecture séquentielle bornée d'un tampon (valeurs little-endian natives)
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t size) : data(data), size(size) {}
+
+    template <typename T>
+    bool read(T& value) {
+        if (pos + sizeof(T) > size) {
+            return false;
+        }
+        std::memcpy(&value, data + pos, sizeof(T));
+        pos += sizeof(T);
+        return true;
+    }
+
+    bool readString(std::string& value) {
+        uint32_t length;
+        if (!read(length) || pos + length > size) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(data + pos), length);
+        pos += length;
+        return true;
+    }
+
+    template <typename T>
+    bool readArray(std::vector<T>& values) {
+        uint32_t count;
+        if (!read(count) || pos + static_cast<size_t>(count) * sizeof(T) > size) {
+            return false;
+        }
+        values.resize(count);
+        if (count > 0) {
+            std::memcpy(values.data(), data + pos, count * sizeof(T));
+        }
+        pos += count * sizeof(T);
+        return true;
+    }
+
+    bool readMagic(const char (&magic)[4]) {
+        if (pos + 4 > size || std::memcmp(data + pos, magic, 4) != 0) {
+            return false;
+        }
+        pos += 4;
+        return true;
+    }
+
+private:
+    const uint8_t* data;
+    size_t size;
+    size_t pos = 0;
+};
+
+// Écriture séquentielle dans un tampon
+class Writer {
+public:
+    template <typename T>
+    void write(const T& value) {
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+        buffer.insert(buffer.end(), p, p + sizeof(T));
+    }
+
+    void writeString(const std::string& value) {
+        write(static_cast<uint32_t>(value.size()));
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+
+    template <typename T>
+    void writeArray(const std::vector<T>& values) {
+        write(static_cast<uint32_t>(values.size()));
+        const uint8_t* p = reinterpret_cast<const uint8_t*>(values.data());
+        buffer.insert(buffer.end(), p, p + values.size() * sizeof(T));
+    }
+
+    void writeMagic(const char (&magic)[4]) {
+        buffer.insert(buffer.end(), magic, magic + 4);
+    }
+
+    std::vector<uint8_t> buffer;
+};
+
+// Lit un fichier en une seule opération (mmap sous POSIX) et appelle parse
+template <typename Parse>
+bool readWholeFile(const std::string& path, Parse parse) {
+#ifdef _WIN32
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        return false;
+    }
+    std::fseek(f, 0, SEEK_END);
+    long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    std::vector<uint8_t> data(size > 0 ? static_cast<size_t>(size) : 0);
+    bool ok = data.empty() || std::fread(data.data(), 1, data.size(), f) == data.size();
+    std::fclose(f);
+    return ok && parse(data.data(), data.size());
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+    size_t size = static_cast<size_t>(info.st_size);
+    void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    bool ok = parse(static_cast<const uint8_t*>(map), size);
+    munmap(map, size);
+    return ok;
+#endif
+}
+
+// Écrit un fichier via un fichier temporaire renommé
+bool writeWholeFile(const std::string& path, const std::vector<uint8_t>& data) {
+    std::string temp = path + ".tmp";
+    std::FILE* f = std::fopen(temp.c_str(), "wb");
+    if (!f) {
+        return false;
+    }
+    bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) {
+        std::remove(temp.c_str());
+        return false;
+    }
+#ifdef _WIN32
+    std::remove(path.c_str());
+#endif
+    return std::rename(temp.c_str(), path.c_str()) == 0;
+}
+
+void makeDirectories(const std::string& path) {
+    for (size_t pos = 1; pos <= path.size(); pos++) {
+        if (pos == path.size() || path[pos] == '/' || path[pos] == '\\') {
+            std::string part = path.substr(0, pos);
+#ifdef _WIN32
+            _mkdir(part.c_str());
+#else
+            mkdir(part.c_str(), 0755);
+#endif
+        }
+    }
+}
+
+// FNV-1a 64 bits
+void hashBytes(uint64_t& hash, const void* data, size_t size) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= p[i];
+        hash *= 1099511628211ull;
+    }
+}
+
+} // namespace
+
+std::string ProfileStore::defaultDirectory() {
+#ifdef _WIN32
+    const char* appData = std::getenv("APPDATA");
+    return std::string(appData ? appData : ".") + "\\noise_inverter";
+#else
+    const char* config = std::getenv("XDG_CONFIG_HOME");
+    if (config && config[0] != '\0') {
+        return std::string(config) + "/noise_inverter";
+    }
+    const char* home = std::getenv("HOME");
+    return std::string(home ? home : ".") + "/.config/noise_inverter";
+#endif
+}
+
+uint64_t ProfileStore::makeKey(const std::string& backendName,
+                               const std::string& inputDevice, const std::string& outputDevice,
+                               unsigned int sampleRate, unsigned int bufferFrames,
+                               unsigned int inputChannels, unsigned int outputChannels) {
+    uint64_t hash = 14695981039346656037ull;
+    // Le séparateur nul évite les collisions entre concaténations
+    hashBytes(hash, backendName.c_str(), backendName.size() + 1);
+    hashBytes(hash, inputDevice.c_str(), inputDevice.size() + 1);
+    hashBytes(hash, outputDevice.c_str(), outputDevice.size() + 1);
+    uint32_t numbers[4] = {sampleRate, bufferFrames, inputChannels, outputChannels};
+    hashBytes(hash, numbers, sizeof(numbers));
+    return hash;
+}
+
+bool ProfileStore::open(const std::string& dir) {
+    directory = dir;
+    profiles.clear();
+    devices.clear();
+    loadProfiles(directory + "/profiles.bin");
+    loadDevices(directory + "/devices.bin");
+    return true;
+}
+
+bool ProfileStore::loadProfiles(const std::string& path) {
+    return readWholeFile(path, [this](const uint8_t* data, size_t size) {
+        Reader reader(data, size);
+        uint32_t version, count;
+        if (!reader.readMagic(profilesMagic) || !reader.read(version) ||
+            version != formatVersion || !reader.read(count)) {
+            return false;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            uint64_t key;
+            CalibrationProfile profile;
+            int32_t filterType;
+            if (!reader.read(key) || !reader.readString(profile.label) ||
+                !reader.read(profile.delayMs) || !reader.read(profile.gain) ||
+                !reader.read(profile.lowFreq) || !reader.read(profile.highFreq) ||
+                !reader.read(filterType) ||
+                !reader.readArray(profile.secondaryPath) || !reader.readArray(profile.adaptiveWeights)) {
+                return false;
+            }
+            profile.filterType = filterType;
+            profiles[key] = std::move(profile);
+        }
+        return true;
+    });
+}
+
+bool ProfileStore::loadDevices(const std::string& path) {
+    return readWholeFile(path, [this](const uint8_t* data, size_t size) {
+        Reader reader(data, size);
+        uint32_t version, backendCount;
+        if (!reader.readMagic(devicesMagic) || !reader.read(version) ||
+            version != formatVersion || !reader.read(backendCount)) {
+            return false;
+        }
+        for (uint32_t b = 0; b < backendCount; b++) {
+            std::string backendName;
+            uint32_t count;
+            if (!reader.readString(backendName) || !reader.read(count)) {
+                return false;
+            }
+            std::vector<AudioDevice>& list = devices[backendName];
+            list.clear();
+            for (uint32_t i = 0; i < count; i++) {
+                AudioDevice device;
+                int32_t id;
+                uint8_t flags;
+                if (!reader.read(id) || !reader.read(flags) || !reader.read(device.maxChannels) ||
+                    !reader.readString(device.name) || !reader.readArray(device.sampleRates)) {
+                    return false;
+                }
+                device.id = id;
+                device.isInput = (flags & 1) != 0;
+                device.isOutput = (flags & 2) != 0;
+                device.isDefault = (flags & 4) != 0;
+                list.push_back(std::move(device));
+            }
+        }
+        return true;
+    });
+}
+
+const CalibrationProfile* ProfileStore::findProfile(uint64_t key) const {
+    auto it = profiles.find(key);
+    return it != profiles.end() ? &it->second : nullptr;
+}
+
+void ProfileStore::storeProfile(uint64_t key, const CalibrationProfile& profile) {
+    profiles[key] = profile;
+}
+
+bool ProfileStore::saveProfiles() const {
+    if (!isOpen()) {
+        return false;
+    }
+
+    Writer writer;
+    writer.writeMagic(profilesMagic);
+    writer.write(formatVersion);
+    writer.write(static_cast<uint32_t>(profiles.size()));
+    for (const auto& entry : profiles) {
+        const CalibrationProfile& profile = entry.second;
+        writer.write(entry.first);
+        writer.writeString(profile.label);
+        writer.write(profile.delayMs);
+        writer.write(profile.gain);
+        writer.write(profile.lowFreq);
+        writer.write(profile.highFreq);
+        writer.write(static_cast<int32_t>(profile.filterType));
+        writer.writeArray(profile.secondaryPath);
+        writer.writeArray(profile.adaptiveWeights);
+    }
+
+    makeDirectories(directory);
+    return writeWholeFile(directory + "/profiles.bin", writer.buffer);
+}
+
+bool ProfileStore::getCachedDevices(const std::string& backendName, std::vector<AudioDevice>& list) const {
+    auto it = devices.find(backendName);
+    if (it == devices.end() || it->second.empty()) {
+        return false;
+    }
+    list = it->second;
+    return true;
+}
+
+void ProfileStore::storeDevices(const std::string& backendName, const std::vector<AudioDevice>& list) {
+    devices[backendName] = list;
+}
+
+bool ProfileStore::saveDevices() const {
+    if (!isOpen()) {
+        return false;
+    }
+
+    Writer writer;
+    writer.writeMagic(devicesMagic);
+    writer.write(formatVersion);
+    writer.write(static_cast<uint32_t>(devices.size()));
+    for (const auto& entry : devices) {
+        writer.writeString(entry.first);
+        writer.write(static_cast<uint32_t>(entry.second.size()));
+        for (const AudioDevice& device : entry.second) {
+            uint8_t flags = (device.isInput ? 1 : 0) | (device.isOutput ? 2 : 0) | (device.isDefault ? 4 : 0);
+            writer.write(static_cast<int32_t>(device.id));
+            writer.write(flags);
+            writer.write(device.maxChannels);
+            writer.writeString(device.name);
+            writer.writeArray(device.sampleRates);
+        }
+    }
+
+    makeDirectories(directory);
+    return writeWholeFile(directory + "/devices.bin", writer.buffer);
+}
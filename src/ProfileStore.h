@@ -0,0 +1,59 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Profil de calibration, associé à un périphérique et une configuration de flux
+struct CalibrationProfile {
+    std::string label;                 // Description lisible de la clé
+    float delayMs = 0.0f;
+    float gain = 1.0f;
+    float lowFreq = 100.0f;
+    float highFreq = 2000.0f;
+    int filterType = 0;
+    std::vector<float> secondaryPath;    // Modèle Ŝ du contrôleur hybride (retard pur puis réponse)
+    std::vector<float> adaptiveWeights;  // Poids W puis C du contrôleur hybride
+};
+
+// Stockage persistant des profils de calibration et du cache des périphériques.
+//
+// Les deux fichiers (profiles.bin, devices.bin) sont lus en une seule fois
+// (mmap sous POSIX) ; l'écriture passe par un fichier temporaire renommé,
+// pour ne jamais laisser un fichier partiellement écrit.
+class ProfileStore {
+public:
+    // Répertoire par défaut : $XDG_CONFIG_HOME/noise_inverter, ~/.config/noise_inverter
+    // ou %APPDATA%\noise_inverter
+    static std::string defaultDirectory();
+
+    // Clé d'un profil : identité des périphériques et configuration du flux
+    static uint64_t makeKey(const std::string& backendName,
+                            const std::string& inputDevice, const std::string& outputDevice,
+                            unsigned int sampleRate, unsigned int bufferFrames,
+                            unsigned int inputChannels, unsigned int outputChannels);
+
+    // Charge les fichiers du répertoire (absents : magasin vide)
+    bool open(const std::string& directory);
+    bool isOpen() const { return !directory.empty(); }
+
+    // Profils
+    const CalibrationProfile* findProfile(uint64_t key) const;
+    void storeProfile(uint64_t key, const CalibrationProfile& profile);
+    bool saveProfiles() const;
+
+    // Cache des périphériques, par backend
+    bool getCachedDevices(const std::string& backendName, std::vector<AudioDevice>& devices) const;
+    void storeDevices(const std::string& backendName, const std::vector<AudioDevice>& devices);
+    bool saveDevices() const;
+
+private:
+    bool loadProfiles(const std::string& path);
+    bool loadDevices(const std::string& path);
+
+    std::string directory;
+    std::unordered_map<uint64_t, CalibrationProfile> profiles;
+    std::unordered_map<std::string, std::vector<AudioDevice>> devices;
+};
@@ -0,0 +1,343 @@
+#include "RealtimeAudit.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef NOISE_INVERTER_RT_AUDIT
+
+#include <cerrno>
+#include <cstdarg>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+// Les fonctions ci-dessous remplacent celles de la libc pour tout le
+// processus (l'exécutable est lié avec -rdynamic). Elles délèguent à
+// l'implémentation d'origine et vérifient seulement si le thread appelant
+// se trouve dans une section temps réel.
+
+namespace {
+
+// Profondeur de section temps réel du thread courant (TLS statique, sans allocation)
+thread_local int realtimeDepth = 0;
+// Évite la récursion pendant un rapport
+thread_local bool reporting = false;
+
+std::atomic<size_t> violations{0};
+std::atomic<bool> abortOnViolation{false};
+
+// Allocations de tous les threads, section temps réel ou non
+std::atomic<size_t> allocations{0};
+
+inline void countAllocation() {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Écriture brute sur stderr, sans passer par les fonctions interceptées
+void rawWrite(const char* text) {
+    syscall(SYS_write, 2, text, std::strlen(text));
+}
+
+void reportViolation(const char* what) {
+    if (realtimeDepth == 0 || reporting) {
+        return;
+    }
+    reporting = true;
+
+    violations.fetch_add(1, std::memory_order_relaxed);
+
+    rawWrite("[RT-AUDIT] ");
+    rawWrite(what);
+    rawWrite(" dans le callback audio\n");
+
+    // Pile d'appels : la première entrée est reportViolation elle-même
+    void* frames[32];
+    int count = backtrace(frames, 32);
+    backtrace_symbols_fd(frames + 1, count - 1, 2);
+
+    if (abortOnViolation.load(std::memory_order_relaxed)) {
+        rawWrite("[RT-AUDIT] Arrêt demandé à la première violation\n");
+        std::abort();
+    }
+
+    reporting = false;
+}
+
+// Résolution des fonctions d'origine
+template <typename Fn>
+Fn resolveNext(const char* name) {
+    return reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+}
+
+using MutexLockFn = int (*)(pthread_mutex_t*);
+using CondWaitFn = int (*)(pthread_cond_t*, pthread_mutex_t*);
+using CondTimedWaitFn = int (*)(pthread_cond_t*, pthread_mutex_t*, const struct timespec*);
+using SemWaitFn = int (*)(sem_t*);
+using NanosleepFn = int (*)(const struct timespec*, struct timespec*);
+using ClockNanosleepFn = int (*)(clockid_t, int, const struct timespec*, struct timespec*);
+using UsleepFn = int (*)(useconds_t);
+using SleepFn = unsigned int (*)(unsigned int);
+using ReadFn = ssize_t (*)(int, void*, size_t);
+using WriteFn = ssize_t (*)(int, const void*, size_t);
+using OpenFn = int (*)(const char*, int, ...);
+using PollFn = int (*)(struct pollfd*, nfds_t, int);
+using SelectFn = int (*)(int, fd_set*, fd_set*, fd_set*, struct timeval*);
+using EpollWaitFn = int (*)(int, struct epoll_event*, int, int);
+
+struct RealFunctions {
+    MutexLockFn mutexLock = nullptr;
+    CondWaitFn condWait = nullptr;
+    CondTimedWaitFn condTimedWait = nullptr;
+    SemWaitFn semWait = nullptr;
+    NanosleepFn nanosleep = nullptr;
+    ClockNanosleepFn clockNanosleep = nullptr;
+    UsleepFn usleep = nullptr;
+    SleepFn sleep = nullptr;
+    ReadFn read = nullptr;
+    WriteFn write = nullptr;
+    OpenFn open = nullptr;
+    PollFn poll = nullptr;
+    SelectFn select = nullptr;
+    EpollWaitFn epollWait = nullptr;
+};
+
+RealFunctions real;
+
+// Résout toutes les fonctions d'origine. Appelée au chargement, mais aussi
+// à la demande si une bibliothèque les utilise avant notre initialisation.
+void resolveRealFunctions() {
+    real.mutexLock = resolveNext<MutexLockFn>("pthread_mutex_lock");
+    // Version moderne des conditions (la version par défaut peut être l'ancienne ABI)
+    real.condWait = reinterpret_cast<CondWaitFn>(dlvsym(RTLD_NEXT, "pthread_cond_wait", "GLIBC_2.3.2"));
+    if (!real.condWait) real.condWait = resolveNext<CondWaitFn>("pthread_cond_wait");
+    real.condTimedWait = reinterpret_cast<CondTimedWaitFn>(dlvsym(RTLD_NEXT, "pthread_cond_timedwait", "GLIBC_2.3.2"));
+    if (!real.condTimedWait) real.condTimedWait = resolveNext<CondTimedWaitFn>("pthread_cond_timedwait");
+    real.semWait = resolveNext<SemWaitFn>("sem_wait");
+    real.nanosleep = resolveNext<NanosleepFn>("nanosleep");
+    real.clockNanosleep = resolveNext<ClockNanosleepFn>("clock_nanosleep");
+    real.usleep = resolveNext<UsleepFn>("usleep");
+    real.sleep = resolveNext<SleepFn>("sleep");
+    real.read = resolveNext<ReadFn>("read");
+    real.write = resolveNext<WriteFn>("write");
+    real.open = resolveNext<OpenFn>("open");
+    real.poll = resolveNext<PollFn>("poll");
+    real.select = resolveNext<SelectFn>("select");
+    real.epollWait = resolveNext<EpollWaitFn>("epoll_wait");
+}
+
+#define NI_REAL(member) (real.member ? real.member : (resolveRealFunctions(), real.member))
+
+// Initialisation anticipée, avant la création des threads audio
+__attribute__((constructor(101))) void initRealtimeAudit() {
+    if (!real.mutexLock) {
+        resolveRealFunctions();
+    }
+
+    // backtrace() charge libgcc au premier appel (allocation) : le faire maintenant
+    void* frames[2];
+    backtrace(frames, 2);
+
+    const char* env = std::getenv("NI_RT_AUDIT_ABORT");
+    if (env && env[0] == '1') {
+        abortOnViolation = true;
+    }
+}
+
+} // namespace
+
+// Allocations : glibc expose ses implémentations internes sous __libc_*
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    countAllocation();
+    reportViolation("Allocation (malloc)");
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    countAllocation();
+    reportViolation("Allocation (calloc)");
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    countAllocation();
+    reportViolation("Allocation (realloc)");
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    if (ptr) {
+        reportViolation("Libération (free)");
+    }
+    __libc_free(ptr);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    countAllocation();
+    reportViolation("Allocation (posix_memalign)");
+    // Alignement : puissance de deux, multiple de sizeof(void*)
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0 || alignment % sizeof(void*) != 0) {
+        return EINVAL;
+    }
+    void* p = __libc_memalign(alignment, size);
+    if (!p) {
+        return ENOMEM;
+    }
+    *ptr = p;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    countAllocation();
+    reportViolation("Allocation (aligned_alloc)");
+    return __libc_memalign(alignment, size);
+}
+
+// Synchronisation bloquante
+int pthread_mutex_lock(pthread_mutex_t* mutex) {
+    reportViolation("Verrouillage de mutex (pthread_mutex_lock)");
+    return NI_REAL(mutexLock)(mutex);
+}
+
+int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex) {
+    reportViolation("Attente de condition (pthread_cond_wait)");
+    return NI_REAL(condWait)(cond, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* abstime) {
+    reportViolation("Attente de condition (pthread_cond_timedwait)");
+    return NI_REAL(condTimedWait)(cond, mutex, abstime);
+}
+
+int sem_wait(sem_t* sem) {
+    reportViolation("Attente de sémaphore (sem_wait)");
+    return NI_REAL(semWait)(sem);
+}
+
+// Mise en sommeil
+int nanosleep(const struct timespec* req, struct timespec* rem) {
+    reportViolation("Mise en sommeil (nanosleep)");
+    return NI_REAL(nanosleep)(req, rem);
+}
+
+int clock_nanosleep(clockid_t clock, int flags, const struct timespec* req, struct timespec* rem) {
+    reportViolation("Mise en sommeil (clock_nanosleep)");
+    return NI_REAL(clockNanosleep)(clock, flags, req, rem);
+}
+
+int usleep(useconds_t usec) {
+    reportViolation("Mise en sommeil (usleep)");
+    return NI_REAL(usleep)(usec);
+}
+
+unsigned int sleep(unsigned int seconds) {
+    reportViolation("Mise en sommeil (sleep)");
+    return NI_REAL(sleep)(seconds);
+}
+
+// Entrées / sorties
+ssize_t read(int fd, void* buf, size_t count) {
+    reportViolation("E/S (read)");
+    return NI_REAL(read)(fd, buf, count);
+}
+
+ssize_t write(int fd, const void* buf, size_t count) {
+    reportViolation("E/S (write)");
+    return NI_REAL(write)(fd, buf, count);
+}
+
+int open(const char* path, int flags, ...) {
+    reportViolation("E/S (open)");
+    mode_t mode = 0;
+    if (flags & (O_CREAT | O_TMPFILE)) {
+        va_list args;
+        va_start(args, flags);
+        mode = va_arg(args, mode_t);
+        va_end(args);
+    }
+    return NI_REAL(open)(path, flags, mode);
+}
+
+int poll(struct pollfd* fds, nfds_t nfds, int timeout) {
+    reportViolation("Attente d'E/S (poll)");
+    return NI_REAL(poll)(fds, nfds, timeout);
+}
+
+int select(int nfds, fd_set* readfds, fd_set* writefds, fd_set* exceptfds, struct timeval* timeout) {
+    reportViolation("Attente d'E/S (select)");
+    return NI_REAL(select)(nfds, readfds, writefds, exceptfds, timeout);
+}
+
+int epoll_wait(int epfd, struct epoll_event* events, int maxevents, int timeout) {
+    reportViolation("Attente d'E/S (epoll_wait)");
+    return NI_REAL(epollWait)(epfd, events, maxevents, timeout);
+}
+} // extern "C"
+
+namespace rtaudit {
+
+ScopedRealtimeSection::ScopedRealtimeSection() {
+    realtimeDepth++;
+}
+
+ScopedRealtimeSection::~ScopedRealtimeSection() {
+    realtimeDepth--;
+}
+
+size_t violationCount() {
+    return violations.load(std::memory_order_relaxed);
+}
+
+size_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+void setAbortOnViolation(bool enabled) {
+    abortOnViolation = enabled;
+}
+
+bool isEnabled() {
+    return true;
+}
+
+} // namespace rtaudit
+
+#else // !NOISE_INVERTER_RT_AUDIT
+
+namespace rtaudit {
+
+ScopedRealtimeSection::ScopedRealtimeSection() {}
+ScopedRealtimeSection::~ScopedRealtimeSection() {}
+
+size_t violationCount() {
+    return 0;
+}
+
+size_t allocationCount() {
+    return 0;
+}
+
+void setAbortOnViolation(bool) {}
+
+bool isEnabled() {
+    return false;
+}
+
+} // namespace rtaudit
+
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+
+// Mode d'audit temps réel (option CMake NOISE_INVERTER_RT_AUDIT, Linux).
+//
+// Pendant une section temps réel (le callback audio), toute allocation sur
+// le tas, tout verrouillage bloquant de mutex, toute attente ou E/S bloquante
+// effectuée par le thread courant est signalée sur stderr avec la pile
+// d'appels. Les autres threads ne sont pas concernés.
+//
+// Sans l'option, les macros ne génèrent aucun code.
+namespace rtaudit {
+
+// Marque le thread courant comme étant dans le callback audio
+class ScopedRealtimeSection {
+public:
+    ScopedRealtimeSection();
+    ~ScopedRealtimeSection();
+
+    ScopedRealtimeSection(const ScopedRealtimeSection&) = delete;
+    ScopedRealtimeSection& operator=(const ScopedRealtimeSection&) = delete;
+};
+
+// Nombre total de violations détectées depuis le démarrage
+size_t violationCount();
+
+// Nombre total d'allocations sur le tas, tous threads confondus
+size_t allocationCount();
+
+// Interrompt le programme à la première violation (aussi via NI_RT_AUDIT_ABORT=1)
+void setAbortOnViolation(bool enabled);
+
+// Vrai si le mode d'audit est compilé
+bool isEnabled();
+
+} // namespace rtaudit
+
+#ifdef NOISE_INVERTER_RT_AUDIT
+#define NI_RT_SECTION() rtaudit::ScopedRealtimeSection niRealtimeSection_
+#else
+#define NI_RT_SECTION() ((void)0)
+#endif
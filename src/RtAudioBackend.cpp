@@ -0,0 +1,252 @@
+#include "RtAudioBackend.h"
+#include <iostream>
+#include <algorithm>
+
+// Liste les périphériques audio disponibles
+std::vector<AudioDevice> RtAudioBackend::listDevices() {
+    std::vector<AudioDevice> deviceList;
+
+    // Obtenir les informations sur les périphériques
+    unsigned int deviceCount = audio.getDeviceCount();
+    std::cout << "Périphériques audio disponibles: " << deviceCount << std::endl;
+
+    for (unsigned int i = 0; i < deviceCount; i++) {
+        RtAudio::DeviceInfo info = audio.getDeviceInfo(i);
+
+        // Supprimé la vérification de info.probed
+        {
+            // Créer une entrée pour le périphérique d'entrée
+            if (info.inputChannels > 0) {
+                AudioDevice device;
+                device.id = i;
+                device.name = info.name;
+                device.isInput = true;
+                device.isOutput = false;
+                device.isDefault = info.isDefaultInput;
+                device.maxChannels = info.inputChannels;
+                device.sampleRates = info.sampleRates;
+
+                deviceList.push_back(device);
+
+                std::cout << "Périphérique " << i << ": " << info.name << " (Entrée)" << std::endl;
+            }
+
+            // Créer une entrée pour le périphérique de sortie
+            if (info.outputChannels > 0) {
+                AudioDevice device;
+                device.id = i + 1000;  // +1000 pour différencier entrée/sortie
+                device.name = info.name;
+                device.isInput = false;
+                device.isOutput = true;
+                device.isDefault = info.isDefaultOutput;
+                device.maxChannels = info.outputChannels;
+                device.sampleRates = info.sampleRates;
+
+                deviceList.push_back(device);
+
+                std::cout << "Périphérique " << i << ": " << info.name << " (Sortie)" << std::endl;
+            }
+
+            // Afficher les informations détaillées
+            std::cout << "  Entrées: " << info.inputChannels
+                      << ", Sorties: " << info.outputChannels << std::endl;
+
+            std::cout << "  Fréquences supportées: ";
+            for (size_t j = 0; j < std::min(size_t(5), info.sampleRates.size()); j++) {
+                std::cout << info.sampleRates[j] << " ";
+            }
+            if (info.sampleRates.size() > 5) {
+                std::cout << "...";
+            }
+            std::cout << std::endl;
+
+            // Vérifier si c'est un périphérique Focusrite
+            if (info.name.find("Focusrite") != std::string::npos ||
+                info.name.find("Saffire") != std::string::npos) {
+                std::cout << "  *** Périphérique Focusrite détecté! ***" << std::endl;
+            }
+        }
+    }
+
+    return deviceList;
+}
+
+// Sonde un seul périphérique (les sorties sont numérotées à partir de 1000)
+std::string RtAudioBackend::deviceName(int id) {
+    bool isOutput = id >= 1000;
+    unsigned int index = static_cast<unsigned int>(isOutput ? id - 1000 : id);
+    if (id < 0 || index >= audio.getDeviceCount()) {
+        return std::string();
+    }
+
+    RtAudio::DeviceInfo info = audio.getDeviceInfo(index);
+    unsigned int channels = isOutput ? info.outputChannels : info.inputChannels;
+    return channels > 0 ? info.name : std::string();
+}
+
+// Vrai si l'entrée et la sortie appartiennent à la même carte (une seule
+// horloge). Selon l'API, les deux voies d'une carte peuvent porter des
+// identifiants distincts mais le même nom.
+bool RtAudioBackend::samePhysicalDevice(unsigned int inputDevice, unsigned int outputDevice) {
+    if (inputDevice == outputDevice) {
+        return true;
+    }
+    try {
+        RtAudio::DeviceInfo input = audio.getDeviceInfo(inputDevice);
+        RtAudio::DeviceInfo output = audio.getDeviceInfo(outputDevice);
+        return !input.name.empty() && input.name == output.name;
+    }
+    catch (const std::exception&) {
+        return false;
+    }
+}
+
+// Ouvre un flux duplex
+bool RtAudioBackend::open(StreamConfig& config, AudioProcessCallback processCallback, void* userData) {
+    try {
+        int inputDevice = config.inputDevice;
+        int outputDevice = config.outputDevice;
+
+        // Ajuster les indices
+        if (inputDevice >= 1000) {
+            inputDevice -= 1000;
+        }
+
+        if (outputDevice >= 1000) {
+            outputDevice -= 1000;
+        }
+
+        // -1 : périphériques par défaut
+        if (inputDevice < 0) {
+            inputDevice = static_cast<int>(audio.getDefaultInputDevice());
+        }
+
+        if (outputDevice < 0) {
+            outputDevice = static_cast<int>(audio.getDefaultOutputDevice());
+        }
+
+        // Deux périphériques distincts n'ont pas la même horloge : un flux
+        // duplex unique dériverait, chaque voie a donc son propre flux.
+        // Les deux voies d'une même carte restent sur un flux duplex.
+        split.reset();
+        if (config.inputChannels > 0 && config.outputChannels > 0 &&
+            !samePhysicalDevice(static_cast<unsigned int>(inputDevice), static_cast<unsigned int>(outputDevice))) {
+            std::cout << "  Entrée: " << inputDevice << ", Sortie: " << outputDevice << std::endl;
+            StreamConfig splitConfig = config;
+            splitConfig.inputDevice = inputDevice;
+            splitConfig.outputDevice = outputDevice + 1000;
+            split = std::make_unique<SplitDeviceBackend>(std::make_unique<RtAudioBackend>(),
+                                                         std::make_unique<RtAudioBackend>());
+            if (!split->open(splitConfig, processCallback, userData)) {
+                split.reset();
+                return false;
+            }
+            config.sampleRate = splitConfig.sampleRate;
+            config.bufferFrames = splitConfig.bufferFrames;
+            return true;
+        }
+
+        RtAudio::StreamParameters inParams;
+        inParams.deviceId = inputDevice;
+        inParams.nChannels = config.inputChannels;
+        inParams.firstChannel = 0;
+
+        RtAudio::StreamParameters outParams;
+        outParams.deviceId = outputDevice;
+        outParams.nChannels = config.outputChannels;
+        outParams.firstChannel = 0;
+
+        RtAudio::StreamOptions options;
+        options.flags = RTAUDIO_MINIMIZE_LATENCY | RTAUDIO_SCHEDULE_REALTIME;
+        options.numberOfBuffers = 2;  // Minimiser les buffers
+        options.priority = 85;  // Haute priorité
+        options.streamName = config.streamName;
+
+        callback = processCallback;
+        callbackUserData = userData;
+
+        std::cout << "  Entrée: " << inputDevice << ", Sortie: " << outputDevice << std::endl;
+
+        audio.openStream(config.outputChannels > 0 ? &outParams : nullptr,
+                         config.inputChannels > 0 ? &inParams : nullptr,
+                         RTAUDIO_FLOAT32, config.sampleRate, &config.bufferFrames,
+                         &rtCallback, this, &options);
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Erreur RtAudio: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+bool RtAudioBackend::start() {
+    if (split) {
+        return split->start();
+    }
+    try {
+        audio.startStream();
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Erreur RtAudio: " << e.what() << std::endl;
+        return false;
+    }
+}
+
+void RtAudioBackend::stop() {
+    if (split) {
+        split->stop();
+        return;
+    }
+    try {
+        if (audio.isStreamRunning()) {
+            audio.stopStream();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Erreur lors de l'arrêt: " << e.what() << std::endl;
+    }
+}
+
+void RtAudioBackend::close() {
+    if (split) {
+        split->close();
+        split.reset();
+        return;
+    }
+    try {
+        if (audio.isStreamOpen()) {
+            audio.closeStream();
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Erreur lors de la fermeture: " << e.what() << std::endl;
+    }
+}
+
+bool RtAudioBackend::isRunning() const {
+    return split ? split->isRunning() : audio.isStreamRunning();
+}
+
+unsigned int RtAudioBackend::extraLatencyFrames() const {
+    return split ? split->extraLatencyFrames() : 0;
+}
+
+// Callback RtAudio : convertit les drapeaux d'état et relaie
+int RtAudioBackend::rtCallback(void* outputBuffer, void* inputBuffer,
+                               unsigned int nFrames, double streamTime,
+                               RtAudioStreamStatus status, void* userData) {
+    RtAudioBackend* self = static_cast<RtAudioBackend*>(userData);
+
+    unsigned int streamStatus = STREAM_OK;
+    if (status & RTAUDIO_INPUT_OVERFLOW) {
+        streamStatus |= STREAM_INPUT_OVERFLOW;
+    }
+    if (status & RTAUDIO_OUTPUT_UNDERFLOW) {
+        streamStatus |= STREAM_OUTPUT_UNDERFLOW;
+    }
+
+    return self->callback(static_cast<float*>(outputBuffer),
+                          static_cast<const float*>(inputBuffer),
+                          nFrames, streamTime, streamStatus, self->callbackUserData);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include "SplitDeviceBackend.h"
+#include <RtAudio.h>
+#include <memory>
+
+// Backend basé sur RtAudio (périphériques réels : ALSA, JACK, WASAPI, ASIO, CoreAudio)
+class RtAudioBackend : public AudioBackend {
+public:
+    const char* name() const override { return "rtaudio"; }
+
+    std::vector<AudioDevice> listDevices() override;
+    std::string deviceName(int id) override;
+
+    bool open(StreamConfig& config, AudioProcessCallback callback, void* userData) override;
+    bool start() override;
+    void stop() override;
+    void close() override;
+
+    bool isRunning() const override;
+    unsigned int extraLatencyFrames() const override;
+
+private:
+    // Entrée et sortie sur la même carte (identifiants résolus)
+    bool samePhysicalDevice(unsigned int inputDevice, unsigned int outputDevice);
+
+    // Callback RtAudio, relaie vers le callback de traitement
+    static int rtCallback(void* outputBuffer, void* inputBuffer,
+                          unsigned int nFrames, double streamTime,
+                          RtAudioStreamStatus status, void* userData);
+
+    RtAudio audio;
+
+    // Entrée et sortie sur deux périphériques : deux flux et conversion
+    // asynchrone entre leurs horloges
+    std::unique_ptr<SplitDeviceBackend> split;
+    AudioProcessCallback callback = nullptr;
+    void* callbackUserData = nullptr;
+};
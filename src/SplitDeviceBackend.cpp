@@ -0,0 +1,406 @@
+#include "SplitDeviceBackend.h"
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Bande passante des DLL (Hz) : large pour l'accrochage, puis étroite pour
+// filtrer la gigue d'ordonnancement tout en suivant une dérive thermique
+constexpr double clockBandwidthLocking = 1.0;
+constexpr double clockBandwidth = 0.05;
+
+// Durée d'observation avant de faire confiance à une DLL (s)
+constexpr double clockLockTime = 2.0;
+
+// Constante de temps du niveau moyen de la file (s)
+constexpr double fillAveraging = 0.5;
+
+// Correcteur PI sur l'écart de latence (s) : amortissement critique
+// (ki = kp² / 4), un écart est résorbé en une dizaine de secondes
+constexpr double proportionalGain = 0.2;
+constexpr double integralGain = 0.01;
+
+// Excursion maximale du rapport autour de sa valeur nominale, et part
+// confiée à l'intégrale (biais des DLL)
+constexpr double maxCorrection = 1e-3;
+constexpr double maxResidual = 1e-4;
+
+// Instant courant en secondes, pour les DLL
+double now() {
+    return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+void SplitDeviceBackend::ClockEstimator::reset(double nominalRate) {
+    nominalPeriod = 1.0 / nominalRate;
+    period = nominalPeriod;
+    nextTime = 0.0;
+    elapsed = 0.0;
+    initialized = false;
+}
+
+void SplitDeviceBackend::ClockEstimator::update(double time, unsigned int nFrames) {
+    if (nFrames == 0) {
+        return;
+    }
+    double blockPeriod = nFrames * period;
+    double error = time - nextTime;
+
+    // Premier bloc, ou blocage prolongé (flux suspendu) : repartir de
+    // l'instant observé en gardant la période estimée
+    if (!initialized || std::abs(error) > 8.0 * blockPeriod) {
+        nextTime = time + blockPeriod;
+        initialized = true;
+        return;
+    }
+
+    // DLL du second ordre : ω = 2π·B·T, b = √2·ω, c = ω²
+    double bandwidth = elapsed < clockLockTime ? clockBandwidthLocking : clockBandwidth;
+    double omega = 2.0 * M_PI * bandwidth * blockPeriod;
+    nextTime += blockPeriod + std::sqrt(2.0) * omega * error;
+    period += omega * omega * error / nFrames;
+    period = std::clamp(period, nominalPeriod * (1.0 - 10 * maxCorrection),
+                        nominalPeriod * (1.0 + 10 * maxCorrection));
+    elapsed += blockPeriod;
+}
+
+SplitDeviceBackend::SplitDeviceBackend(std::unique_ptr<AudioBackend> captureBackend,
+                                       std::unique_ptr<AudioBackend> playbackBackend)
+    : capture(std::move(captureBackend)), playback(std::move(playbackBackend)) {
+}
+
+SplitDeviceBackend::~SplitDeviceBackend() {
+    stop();
+}
+
+std::vector<AudioDevice> SplitDeviceBackend::listDevices() {
+    std::vector<AudioDevice> devices;
+    for (const AudioDevice& device : capture->listDevices()) {
+        if (device.isInput) {
+            devices.push_back(device);
+        }
+    }
+    for (const AudioDevice& device : playback->listDevices()) {
+        if (device.isOutput) {
+            devices.push_back(device);
+        }
+    }
+    return devices;
+}
+
+std::string SplitDeviceBackend::deviceName(int id) {
+    return id >= 1000 ? playback->deviceName(id) : capture->deviceName(id);
+}
+
+bool SplitDeviceBackend::open(StreamConfig& config, AudioProcessCallback processCallback, void* userData) {
+    callback = processCallback;
+    callbackUserData = userData;
+    channels = std::max(1u, config.inputChannels);
+
+    StreamConfig captureConfig = config;
+    captureConfig.outputChannels = 0;
+    captureConfig.inputChannels = channels;
+    captureConfig.streamName = config.streamName + " (entrée)";
+    if (!capture->open(captureConfig, &SplitDeviceBackend::captureCallback, this)) {
+        return false;
+    }
+
+    StreamConfig playbackConfig = config;
+    playbackConfig.inputChannels = 0;
+    playbackConfig.streamName = config.streamName + " (sortie)";
+    if (!playback->open(playbackConfig, &SplitDeviceBackend::playbackCallback, this)) {
+        capture->close();
+        return false;
+    }
+
+    // Le traitement suit la voie de sortie
+    config.sampleRate = playbackConfig.sampleRate;
+    config.bufferFrames = playbackConfig.bufferFrames;
+    inputRate = captureConfig.sampleRate;
+    outputRate = playbackConfig.sampleRate;
+    outputFrames = playbackConfig.bufferFrames;
+    outputChannels = playbackConfig.outputChannels;
+    nominalRatio = static_cast<double>(inputRate) / outputRate;
+
+    // Consigne du niveau continu : un bloc de lecture, un bloc de capture
+    // (le niveau réel est en retard d'au plus un bloc) et un bloc entier de
+    // marge contre la gigue
+    captureBlock = captureConfig.bufferFrames;
+    double playbackBlock = outputFrames * nominalRatio;
+    targetFill = playbackBlock + captureBlock + std::max(captureBlock, playbackBlock);
+    fillBand = std::max(captureBlock, playbackBlock);
+    maxFill = static_cast<size_t>(2 * targetFill + captureBlock);
+
+    size_t ringFrames = std::max<size_t>(static_cast<size_t>(4 * targetFill), inputRate / 2);
+    ring = std::make_unique<SpscRing<float>>(ringFrames * channels);
+
+    unsigned int maxInputFrames = static_cast<unsigned int>(outputFrames * nominalRatio * (1.0 + maxCorrection)) + 2;
+    resampler.prepare(channels, nominalRatio, maxInputFrames);
+    staging.assign(static_cast<size_t>(maxInputFrames) * channels, 0.0f);
+    resampled.assign(static_cast<size_t>(outputFrames) * channels, 0.0f);
+
+    std::cout << "  Périphériques distincts : conversion asynchrone "
+              << inputRate << " -> " << outputRate << " Hz, file cible "
+              << static_cast<unsigned int>(targetFill) << " trames" << std::endl;
+    return true;
+}
+
+bool SplitDeviceBackend::start() {
+    ring->clear();
+    resampler.reset();
+    captureClock.reset(inputRate);
+    playbackClock.reset(outputRate);
+    captureRate.store(inputRate, std::memory_order_relaxed);
+    captureLocked.store(false, std::memory_order_relaxed);
+    captureOverrun.store(false, std::memory_order_relaxed);
+    captureSequence.store(0, std::memory_order_relaxed);
+    capturedFrames.store(0, std::memory_order_relaxed);
+    captureTime.store(0.0, std::memory_order_relaxed);
+    consumedFrames = 0;
+    primed = false;
+    owedFrames = 0;
+    fillAverage = 0.0;
+    integral = 0.0;
+    clocksLocked = false;
+    ratio = nominalRatio;
+
+    if (!capture->start()) {
+        return false;
+    }
+    if (!playback->start()) {
+        capture->stop();
+        return false;
+    }
+    return true;
+}
+
+void SplitDeviceBackend::stop() {
+    playback->stop();
+    capture->stop();
+}
+
+void SplitDeviceBackend::close() {
+    playback->close();
+    capture->close();
+}
+
+// La perte d'un seul des deux périphériques interrompt le flux
+bool SplitDeviceBackend::isRunning() const {
+    return capture->isRunning() && playback->isRunning();
+}
+
+bool SplitDeviceBackend::isFinished() const {
+    return capture->isFinished() || playback->isFinished();
+}
+
+bool SplitDeviceBackend::isRealtime() const {
+    return capture->isRealtime() && playback->isRealtime();
+}
+
+unsigned int SplitDeviceBackend::extraLatencyFrames() const {
+    // File à sa consigne puis retard de groupe du noyau, en trames de sortie
+    return static_cast<unsigned int>((targetFill + AsyncResampler::delayFrames()) / nominalRatio);
+}
+
+SplitDeviceBackend::Stats SplitDeviceBackend::getStats() const {
+    Stats stats;
+    stats.ratio = statusRatio.load(std::memory_order_relaxed);
+    stats.driftPpm = (stats.ratio / nominalRatio - 1.0) * 1e6;
+    stats.fillFrames = statusFill.load(std::memory_order_relaxed);
+    stats.targetFrames = targetFill;
+    stats.underruns = underrunCount.load(std::memory_order_relaxed);
+    stats.overruns = overrunCount.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// Thread de capture : empile les trames entrelacées
+int SplitDeviceBackend::captureCallback(float*, const float* input, unsigned int nFrames,
+                                        double, unsigned int status, void* userData) {
+    NI_TRACE_SCOPE("capture", nFrames);
+    SplitDeviceBackend* self = static_cast<SplitDeviceBackend*>(userData);
+
+    double time = now();
+    self->captureClock.update(time, nFrames);
+    if (self->captureClock.elapsed >= clockLockTime) {
+        self->captureRate.store(self->captureClock.rate(), std::memory_order_relaxed);
+        self->captureLocked.store(true, std::memory_order_release);
+    }
+
+    // Trames entières seulement, pour ne pas décaler les canaux
+    size_t count = static_cast<size_t>(nFrames) * self->channels;
+    SpscRing<float>& ring = *self->ring;
+    if (ring.capacity() - ring.size() >= count) {
+        ring.write(input, count);
+        self->publishCapture(time, nFrames);
+    } else {
+        self->overrunCount.fetch_add(1, std::memory_order_relaxed);
+        self->captureOverrun.store(true, std::memory_order_relaxed);
+        NI_TRACE_INSTANT("file pleine", static_cast<double>(ring.size()));
+    }
+    if (status & STREAM_INPUT_OVERFLOW) {
+        self->captureOverrun.store(true, std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+// Thread de lecture : cadence le traitement
+int SplitDeviceBackend::playbackCallback(float* output, const float*, unsigned int nFrames,
+                                         double streamTime, unsigned int status, void* userData) {
+    NI_TRACE_SCOPE("lecture", nFrames);
+    SplitDeviceBackend* self = static_cast<SplitDeviceBackend*>(userData);
+    double time = now();
+    self->playbackClock.update(time, nFrames);
+
+    // Blocs plus grands que prévu : traités par morceaux
+    int result = 0;
+    for (unsigned int done = 0; done < nFrames && result == 0; ) {
+        unsigned int chunk = std::min(nFrames - done, self->outputFrames);
+        double offset = static_cast<double>(done) / self->outputRate;
+        result = self->processPlayback(output + static_cast<size_t>(done) * self->outputChannels, chunk,
+                                       streamTime + offset, time + offset, status);
+        done += chunk;
+    }
+    return result;
+}
+
+// Thread de capture : instant et total des trames écrites (verrou de séquence)
+void SplitDeviceBackend::publishCapture(double time, unsigned int nFrames) {
+    unsigned int sequence = captureSequence.load(std::memory_order_relaxed);
+    captureSequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    capturedFrames.store(capturedFrames.load(std::memory_order_relaxed) + nFrames, std::memory_order_relaxed);
+    captureTime.store(time, std::memory_order_relaxed);
+    captureSequence.store(sequence + 2, std::memory_order_release);
+}
+
+// Thread de lecture : lit des trames entières et tient le compte consommé
+size_t SplitDeviceBackend::readFrames(float* data, size_t frames) {
+    size_t got = ring->read(data, frames * channels) / channels;
+    consumedFrames += got;
+    return got;
+}
+
+// Niveau de la file à l'instant time, sans les dents de scie des blocs de
+// capture : les trames arrivées sont extrapolées depuis le dernier callback
+double SplitDeviceBackend::continuousFill(double time) const {
+    uint64_t frames;
+    double lastTime;
+    unsigned int before, after;
+    do {
+        before = captureSequence.load(std::memory_order_acquire);
+        frames = capturedFrames.load(std::memory_order_relaxed);
+        lastTime = captureTime.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = captureSequence.load(std::memory_order_relaxed);
+    } while (before != after || (before & 1));
+
+    double elapsed = std::clamp(time - lastTime, 0.0, 2.0 * captureBlock / inputRate);
+    return static_cast<double>(frames) - static_cast<double>(consumedFrames) + elapsed * inputRate;
+}
+
+// Rapport des horloges : DLL si verrouillées, corrigé par le niveau de la file
+void SplitDeviceBackend::updateRatio(unsigned int nFrames, double time) {
+    double fill = continuousFill(time);
+    double dt = static_cast<double>(nFrames) / outputRate;
+    fillAverage += std::min(1.0, dt / fillAveraging) * (fill - fillAverage);
+
+    // Les DLL fournissent la dérive dès leur accrochage : l'intégrale, qui
+    // la compensait jusque-là, repart de zéro pour ne pas la compter deux fois
+    double base = nominalRatio;
+    bool locked = captureLocked.load(std::memory_order_acquire) && playbackClock.elapsed >= clockLockTime;
+    if (locked) {
+        base = captureRate.load(std::memory_order_relaxed) / playbackClock.rate();
+        if (!clocksLocked) {
+            integral = 0.0;
+        }
+    }
+    clocksLocked = locked;
+
+    // Erreur en secondes de latence, pour des gains indépendants de la fréquence
+    double error = (fillAverage - targetFill) / inputRate;
+    // Anti-emballement : l'intégrale n'évolue que près de la consigne et hors
+    // rattrapage d'un manque ; les grands écarts relèvent du seul terme P
+    if (owedFrames == 0 && std::abs(fillAverage - targetFill) < fillBand) {
+        double limit = maxResidual / integralGain;
+        integral = std::clamp(integral + error * dt, -limit, limit);
+    }
+    double correction = std::clamp(proportionalGain * error + integralGain * integral,
+                                   -maxCorrection, maxCorrection);
+
+    ratio = std::clamp(base * (1.0 + correction),
+                       nominalRatio * (1.0 - maxCorrection), nominalRatio * (1.0 + maxCorrection));
+    statusRatio.store(ratio, std::memory_order_relaxed);
+    statusFill.store(fillAverage, std::memory_order_relaxed);
+}
+
+int SplitDeviceBackend::processPlayback(float* output, unsigned int nFrames, double streamTime,
+                                        double time, unsigned int status) {
+    // Débordement côté capture, ou latence hors tolérance après un blocage
+    // de la lecture : revenir à la consigne en jetant l'excédent
+    bool overrun = captureOverrun.exchange(false, std::memory_order_relaxed);
+    if (ring->size() / channels > maxFill) {
+        overrunCount.fetch_add(1, std::memory_order_relaxed);
+        overrun = true;
+    }
+    if (overrun) {
+        NI_TRACE_INSTANT("débordement", static_cast<double>(ring->size() / channels));
+        status |= STREAM_INPUT_OVERFLOW;
+        size_t excess = ring->size() / channels;
+        excess = excess > targetFill ? excess - static_cast<size_t>(targetFill) : 0;
+        while (excess > 0) {
+            size_t frames = std::min(excess, staging.size() / channels);
+            readFrames(staging.data(), frames);
+            excess -= frames;
+        }
+        fillAverage = targetFill;
+        owedFrames = 0;
+    }
+
+    // Trames remplacées par du silence lors d'un manque : jetées à leur
+    // arrivée (au-delà de la consigne), pour que la latence revienne à sa valeur
+    size_t level = ring->size() / channels;
+    if (owedFrames > 0 && level > targetFill) {
+        size_t surplus = level - static_cast<size_t>(targetFill);
+        size_t frames = std::min({owedFrames, surplus, staging.size() / channels});
+        readFrames(staging.data(), frames);
+        owedFrames -= frames;
+    }
+
+    // Remplissage initial jusqu'à la consigne : silence en entrée
+    size_t available = ring->size() / channels;
+    if (!primed) {
+        if (available < targetFill) {
+            std::fill(resampled.begin(), resampled.end(), 0.0f);
+            return callback(output, resampled.data(), nFrames, streamTime, status, callbackUserData);
+        }
+        primed = true;
+        fillAverage = static_cast<double>(available);
+    }
+
+    updateRatio(nFrames, time);
+    NI_TRACE_COUNTER("rapport horloges", ratio);
+    unsigned int needed = resampler.inputFramesNeeded(nFrames, ratio);
+    size_t count = static_cast<size_t>(needed) * channels;
+    size_t got = readFrames(staging.data(), needed) * channels;
+    if (got < count) {
+        // Manque (capture en retard) : compléter par du silence
+        std::fill(staging.begin() + got, staging.begin() + count, 0.0f);
+        owedFrames += (count - got) / channels;
+        underrunCount.fetch_add(1, std::memory_order_relaxed);
+        NI_TRACE_INSTANT("manque", static_cast<double>((count - got) / channels));
+        status |= STREAM_INPUT_UNDERFLOW;
+    }
+
+    resampler.process(resampled.data(), staging.data(), nFrames, ratio);
+    return callback(output, resampled.data(), nFrames, streamTime, status, callbackUserData);
+}
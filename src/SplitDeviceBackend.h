@@ -0,0 +1,131 @@
+#pragma once
+
+#include "AsyncResampler.h"
+#include "AudioBackend.h"
+#include "SpscRing.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Entrée et sortie sur deux périphériques distincts, chacun avec sa propre
+// horloge. Le flux de capture remplit une file sans verrou ; le traitement
+// est cadencé par le flux de lecture, qui tire l'entrée à travers un
+// rééchantillonneur asynchrone.
+//
+// Le rapport des horloges est estimé de deux façons complémentaires :
+//   - une boucle à verrouillage de retard (DLL) par flux, sur les instants
+//     des callbacks, donne les fréquences réelles et donc le rapport brut ;
+//   - un correcteur PI sur le niveau moyen de la file retire l'erreur
+//     résiduelle et maintient ce niveau à une consigne fixe.
+// La latence ajoutée reste ainsi constante quelle que soit la dérive. Après
+// un incident, elle revient à la consigne au lieu de changer durablement :
+// le silence inséré lors d'un manque est rattrapé en jetant autant de
+// trames à leur arrivée, et un excès au-delà de la tolérance est jeté.
+class SplitDeviceBackend : public AudioBackend {
+public:
+    struct Stats {
+        double ratio;               // Trames d'entrée consommées par trame de sortie
+        double driftPpm;            // Écart du rapport à sa valeur nominale
+        double fillFrames;          // Niveau moyen continu de la file (trames d'entrée)
+        double targetFrames;        // Consigne
+        uint64_t underruns;         // File vide au moment de lire
+        uint64_t overruns;          // File pleine, ou latence hors tolérance
+    };
+
+    // capture : backend ouvert en entrée seule ; playback : en sortie seule
+    SplitDeviceBackend(std::unique_ptr<AudioBackend> capture, std::unique_ptr<AudioBackend> playback);
+    ~SplitDeviceBackend() override;
+
+    const char* name() const override { return "split"; }
+
+    std::vector<AudioDevice> listDevices() override;
+    std::string deviceName(int id) override;
+
+    bool open(StreamConfig& config, AudioProcessCallback callback, void* userData) override;
+    bool start() override;
+    void stop() override;
+    void close() override;
+
+    bool isRunning() const override;
+    bool isFinished() const override;
+    bool isRealtime() const override;
+    unsigned int extraLatencyFrames() const override;
+
+    Stats getStats() const;
+
+private:
+    // Estimation de la fréquence réelle d'un flux à partir des instants de
+    // ses callbacks (DLL du second ordre)
+    struct ClockEstimator {
+        void reset(double nominalRate);
+        void update(double time, unsigned int nFrames);
+        double rate() const { return 1.0 / period; }
+
+        double nominalPeriod = 0.0;
+        double period = 0.0;         // Secondes par trame
+        double nextTime = 0.0;       // Instant prévu du prochain callback
+        double elapsed = 0.0;        // Durée observée depuis le premier callback
+        bool initialized = false;
+    };
+
+    static int captureCallback(float* output, const float* input, unsigned int nFrames,
+                               double streamTime, unsigned int status, void* userData);
+    static int playbackCallback(float* output, const float* input, unsigned int nFrames,
+                                double streamTime, unsigned int status, void* userData);
+
+    int processPlayback(float* output, unsigned int nFrames, double streamTime, double time,
+                        unsigned int status);
+    void publishCapture(double time, unsigned int nFrames);
+    size_t readFrames(float* data, size_t frames);
+    double continuousFill(double time) const;
+    void updateRatio(unsigned int nFrames, double time);
+
+    std::unique_ptr<AudioBackend> capture;
+    std::unique_ptr<AudioBackend> playback;
+    AudioProcessCallback callback = nullptr;
+    void* callbackUserData = nullptr;
+
+    unsigned int channels = 1;
+    unsigned int inputRate = 48000;
+    unsigned int outputRate = 48000;
+    unsigned int outputFrames = 128;
+    unsigned int outputChannels = 2;
+    double nominalRatio = 1.0;
+    double captureBlock = 128.0;
+    double targetFill = 0.0;
+    double fillBand = 0.0;           // Écart toléré pour l'intégrale
+    size_t maxFill = 0;              // Au-delà, l'excédent est jeté
+
+    // Capture -> lecture
+    std::unique_ptr<SpscRing<float>> ring;
+    std::atomic<bool> captureOverrun{false};
+
+    // État du thread de lecture
+    AsyncResampler resampler;
+    ClockEstimator captureClock;     // Mis à jour par le thread de capture
+    ClockEstimator playbackClock;
+    std::vector<float> staging;      // Trames d'entrée brutes
+    std::vector<float> resampled;    // Entrée au rythme de la sortie
+    bool primed = false;
+    size_t owedFrames = 0;           // Silence inséré, à rattraper
+    double fillAverage = 0.0;
+    double integral = 0.0;
+    bool clocksLocked = false;
+    double ratio = 1.0;
+
+    // Publié par le thread de capture : fréquence estimée, puis instant et
+    // total des trames du dernier bloc (cohérents grâce au numéro de séquence)
+    std::atomic<double> captureRate{48000.0};
+    std::atomic<bool> captureLocked{false};
+    std::atomic<unsigned int> captureSequence{0};
+    std::atomic<uint64_t> capturedFrames{0};
+    std::atomic<double> captureTime{0.0};
+    uint64_t consumedFrames = 0;     // Thread de lecture
+
+    // Statistiques
+    std::atomic<double> statusRatio{1.0};
+    std::atomic<double> statusFill{0.0};
+    std::atomic<uint64_t> underrunCount{0};
+    std::atomic<uint64_t> overrunCount{0};
+};
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// File circulaire sans verrou, un seul producteur et un seul consommateur.
+// La capacité est arrondie à une puissance de deux. Aucune allocation après
+// la construction : utilisable depuis le thread audio.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t minCapacity = 1024) {
+        size_t capacity = 1;
+        while (capacity < minCapacity) {
+            capacity <<= 1;
+        }
+        items.resize(capacity);
+        mask = capacity - 1;
+    }
+
+    // Producteur : retourne false si la file est pleine
+    bool push(const T& item) {
+        size_t head = writeIndex.load(std::memory_order_relaxed);
+        if (head - readIndex.load(std::memory_order_acquire) > mask) {
+            return false;
+        }
+        items[head & mask] = item;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consommateur : retourne false si la file est vide
+    bool pop(T& item) {
+        size_t tail = readIndex.load(std::memory_order_relaxed);
+        if (tail == writeIndex.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[tail & mask];
+        readIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producteur : écrit au plus count éléments, retourne le nombre écrit
+    size_t write(const T* data, size_t count) {
+        size_t head = writeIndex.load(std::memory_order_relaxed);
+        size_t space = capacity() - (head - readIndex.load(std::memory_order_acquire));
+        count = std::min(count, space);
+        for (size_t i = 0; i < count; i++) {
+            items[(head + i) & mask] = data[i];
+        }
+        writeIndex.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Consommateur : lit au plus count éléments, retourne le nombre lu
+    size_t read(T* data, size_t count) {
+        size_t tail = readIndex.load(std::memory_order_relaxed);
+        size_t available = writeIndex.load(std::memory_order_acquire) - tail;
+        count = std::min(count, available);
+        for (size_t i = 0; i < count; i++) {
+            data[i] = items[(tail + i) & mask];
+        }
+        readIndex.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Nombre d'éléments disponibles (approximatif hors des deux threads)
+    size_t size() const {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Vide la file (producteur et consommateur arrêtés)
+    void clear() {
+        readIndex.store(0, std::memory_order_relaxed);
+        writeIndex.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    std::vector<T> items;
+    size_t mask = 0;
+
+    // Indices sur des lignes de cache distinctes
+    alignas(64) std::atomic<size_t> writeIndex{0};
+    alignas(64) std::atomic<size_t> readIndex{0};
+};
@@ -0,0 +1,194 @@
+#include "TonalCanceller.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+// Plage de suivi autour du fondamental nominal
+constexpr float trackingRange = 0.10f;
+
+// Gain de la boucle de suivi (fraction de l'écart mesuré corrigée par bloc)
+constexpr float trackingGain = 0.5f;
+
+// Amplitude minimale du fondamental pour que sa phase soit exploitable
+constexpr float trackingMinPower = 1e-8f;
+
+} // namespace
+
+void TonalCanceller::prepare(unsigned int rate) {
+    sampleRate = rate;
+    configGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void TonalCanceller::configure(float fundamentalHz, unsigned int harmonicCount, float stepSize) {
+    if (fundamentalHz > 0.0f) {
+        requestedFundamental.store(fundamentalHz, std::memory_order_relaxed);
+    }
+    if (harmonicCount > 0) {
+        requestedHarmonics.store(std::min(harmonicCount, maxHarmonics), std::memory_order_relaxed);
+    }
+    if (stepSize > 0.0f) {
+        requestedStep.store(stepSize, std::memory_order_relaxed);
+    }
+    configGeneration.fetch_add(1, std::memory_order_release);
+}
+
+void TonalCanceller::reset() {
+    appliedGeneration = configGeneration.load(std::memory_order_acquire);
+
+    float fundamental = requestedFundamental.load(std::memory_order_relaxed);
+    omegaNominal = static_cast<float>(2.0 * M_PI * fundamental / sampleRate);
+    omega = omegaNominal;
+    trackedFrequency.store(fundamental, std::memory_order_relaxed);
+
+    // Harmoniques sous 0.45·fs même en haut de la plage de suivi
+    float limit = 0.45f * 2.0f * static_cast<float>(M_PI);
+    harmonics = 0;
+    unsigned int requested = requestedHarmonics.load(std::memory_order_relaxed);
+    while (harmonics < requested && (harmonics + 1) * omegaNominal * (1.0f + trackingRange) < limit) {
+        harmonics++;
+    }
+    paddedHarmonics = (harmonics + lanes - 1) / lanes * lanes;
+
+    // Pas LMS normalisé par la puissance totale des références (0.5 par composante)
+    mu = harmonics > 0 ? requestedStep.load(std::memory_order_relaxed) / harmonics : 0.0f;
+
+    // Les harmoniques inactives gardent un oscillateur nul et ne contribuent pas
+    for (unsigned int k = 0; k < maxHarmonics; k++) {
+        oscCos[k] = k < harmonics ? 1.0f : 0.0f;
+        oscSin[k] = 0.0f;
+        weightI[k] = 0.0f;
+        weightQ[k] = 0.0f;
+    }
+    phaseValid = false;
+}
+
+void TonalCanceller::updateRotations(float advanceSamples) {
+    for (unsigned int k = 0; k < harmonics; k++) {
+        float w = (k + 1) * omega;
+        rotCos[k] = std::cos(w);
+        rotSin[k] = std::sin(w);
+        advCos[k] = std::cos(w * advanceSamples);
+        advSin[k] = std::sin(w * advanceSamples);
+    }
+}
+
+void TonalCanceller::trackFrequency(unsigned int nFrames) {
+    // Estimation = A·cos(φ - ψ) avec wI = A·cos ψ, wQ = A·sin ψ : un écart de
+    // fréquence Δω fait tourner ψ de -Δω par échantillon
+    float power = weightI[0] * weightI[0] + weightQ[0] * weightQ[0];
+    if (power < trackingMinPower || nFrames == 0) {
+        phaseValid = false;
+        return;
+    }
+
+    float phase = std::atan2(weightQ[0], weightI[0]);
+    if (phaseValid) {
+        float delta = phase - lastPhase;
+        if (delta > static_cast<float>(M_PI)) delta -= static_cast<float>(2.0 * M_PI);
+        if (delta < -static_cast<float>(M_PI)) delta += static_cast<float>(2.0 * M_PI);
+
+        omega -= trackingGain * delta / nFrames;
+        omega = std::clamp(omega, omegaNominal * (1.0f - trackingRange),
+                           omegaNominal * (1.0f + trackingRange));
+        trackedFrequency.store(static_cast<float>(omega * sampleRate / (2.0 * M_PI)),
+                               std::memory_order_relaxed);
+    }
+    lastPhase = phase;
+    phaseValid = true;
+}
+
+template <unsigned int Count>
+void TonalCanceller::processHarmonics(float* output, const float* input, unsigned int nFrames,
+                                      unsigned int outChannels, float gain) {
+    // État copié en local : avec une taille connue à la compilation, les
+    // oscillateurs et les poids restent en registres sur tout le bloc
+    float c[Count], s[Count], wI[Count], wQ[Count];
+    float rc[Count], rs[Count], ac[Count], as[Count];
+    for (unsigned int k = 0; k < Count; k++) {
+        c[k] = oscCos[k];
+        s[k] = oscSin[k];
+        wI[k] = weightI[k];
+        wQ[k] = weightQ[k];
+        rc[k] = rotCos[k];
+        rs[k] = rotSin[k];
+        ac[k] = advCos[k];
+        as[k] = advSin[k];
+    }
+    const float step = mu;
+    const float negGain = -gain;
+
+    for (unsigned int n = 0; n < nFrames; n++) {
+        // Estimation courante et anti-bruit avancé, harmonique par harmonique
+        float estimateTerms[Count];
+        float advancedTerms[Count];
+        for (unsigned int k = 0; k < Count; k++) {
+            float cAdv = c[k] * ac[k] - s[k] * as[k];
+            float sAdv = s[k] * ac[k] + c[k] * as[k];
+            estimateTerms[k] = wI[k] * c[k] + wQ[k] * s[k];
+            advancedTerms[k] = wI[k] * cAdv + wQ[k] * sAdv;
+        }
+        // Réduction par voies SIMD puis horizontale
+        for (unsigned int j = lanes; j < Count; j += lanes) {
+            for (unsigned int l = 0; l < lanes; l++) {
+                estimateTerms[l] += estimateTerms[j + l];
+                advancedTerms[l] += advancedTerms[j + l];
+            }
+        }
+        float estimate = 0.0f;
+        float advanced = 0.0f;
+        for (unsigned int l = 0; l < lanes; l++) {
+            estimate += estimateTerms[l];
+            advanced += advancedTerms[l];
+        }
+
+        // LMS sur toutes les harmoniques, puis rotation des oscillateurs
+        float error = step * (input[n] - estimate);
+        for (unsigned int k = 0; k < Count; k++) {
+            float ck = c[k];
+            float sk = s[k];
+            wI[k] += error * ck;
+            wQ[k] += error * sk;
+            c[k] = ck * rc[k] - sk * rs[k];
+            s[k] = sk * rc[k] + ck * rs[k];
+        }
+
+        float out = negGain * advanced;
+        for (unsigned int ch = 0; ch < outChannels; ch++) {
+            output[n * outChannels + ch] = out;
+        }
+    }
+
+    // Renormalisation des oscillateurs (dérive d'arrondi de la récurrence)
+    for (unsigned int k = 0; k < Count; k++) {
+        float g = 1.5f - 0.5f * (c[k] * c[k] + s[k] * s[k]);
+        oscCos[k] = c[k] * g;
+        oscSin[k] = s[k] * g;
+        weightI[k] = wI[k];
+        weightQ[k] = wQ[k];
+    }
+}
+
+void TonalCanceller::process(float* output, const float* input, unsigned int nFrames,
+                             unsigned int outChannels, float gain, float advanceSamples) {
+    if (configGeneration.load(std::memory_order_acquire) != appliedGeneration) {
+        reset();
+    }
+    updateRotations(advanceSamples);
+
+    switch (paddedHarmonics / lanes) {
+        case 0:
+            std::fill(output, output + nFrames * outChannels, 0.0f);
+            return;
+        case 1: processHarmonics<1 * lanes>(output, input, nFrames, outChannels, gain); break;
+        case 2: processHarmonics<2 * lanes>(output, input, nFrames, outChannels, gain); break;
+        case 3: processHarmonics<3 * lanes>(output, input, nFrames, outChannels, gain); break;
+        default: processHarmonics<4 * lanes>(output, input, nFrames, outChannels, gain); break;
+    }
+
+    trackFrequency(nFrames);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+
+// Annulation tonale : bruit périodique (ventilateur, transformateur, moteur)
+// formé d'un fondamental et de ses harmoniques.
+//
+// Chaque harmonique k possède un oscillateur récursif (cos, sin) tournant à
+// k·ω et deux poids (wI, wQ) adaptés par LMS : l'estimation
+// Σ wI·cos + wQ·sin reproduit la composante tonale de l'entrée (filtre
+// coupe-bande adaptatif). L'anti-bruit est cette estimation avancée de la
+// latence du système, ce qu'autorise un signal périodique. La fréquence est
+// suivie par une boucle à verrouillage de phase sur la rotation des poids du
+// fondamental.
+//
+// Coût en O(harmoniques) par échantillon. Les états sont rangés en tableaux
+// (SoA) dont la taille est un multiple de `lanes`, de sorte que toutes les
+// harmoniques sont mises à jour ensemble dans les registres SIMD.
+class TonalCanceller {
+public:
+    static constexpr unsigned int maxHarmonics = 32;
+    static constexpr unsigned int lanes = 8;
+    static_assert(maxHarmonics % lanes == 0 && maxHarmonics <= 4 * lanes,
+                  "process() couvre au plus quatre groupes de lanes");
+
+    // Hors du thread audio : fréquence d'échantillonnage du flux
+    void prepare(unsigned int sampleRate);
+
+    // Fondamental nominal, nombre d'harmoniques et pas d'adaptation
+    // (0 pour laisser inchangé). Appliqué par le thread audio au début du
+    // bloc suivant, avec remise à zéro de l'état adapté.
+    void configure(float fundamentalHz, unsigned int harmonics, float stepSize = 0.0f);
+
+    // Fréquence fondamentale suivie (Hz)
+    float getTrackedFrequency() const { return trackedFrequency.load(std::memory_order_relaxed); }
+    unsigned int getHarmonics() const { return requestedHarmonics.load(std::memory_order_relaxed); }
+
+    // Thread audio : oubli de l'état adapté (poids, phases, fréquence)
+    void reset();
+
+    // Thread audio : écrit -gain × (estimation tonale avancée de
+    // advanceSamples) sur chaque canal de sortie
+    void process(float* output, const float* input, unsigned int nFrames,
+                 unsigned int outChannels, float gain, float advanceSamples);
+
+private:
+    // Rotations par échantillon et avance de phase de chaque harmonique
+    void updateRotations(float advanceSamples);
+
+    // Traitement d'un bloc pour Count harmoniques (multiple de lanes)
+    template <unsigned int Count>
+    void processHarmonics(float* output, const float* input, unsigned int nFrames,
+                          unsigned int outChannels, float gain);
+
+    // Boucle à verrouillage de phase sur les poids du fondamental
+    void trackFrequency(unsigned int nFrames);
+
+    // Configuration demandée (écrite hors du thread audio)
+    std::atomic<float> requestedFundamental{50.0f};
+    std::atomic<unsigned int> requestedHarmonics{8};
+    std::atomic<float> requestedStep{0.01f};
+    std::atomic<unsigned int> configGeneration{1};
+    std::atomic<float> trackedFrequency{50.0f};
+    unsigned int sampleRate = 48000;
+
+    // État du thread audio
+    unsigned int appliedGeneration = 0;
+    unsigned int harmonics = 0;        // Harmoniques actives
+    unsigned int paddedHarmonics = 0;  // Arrondi au multiple de lanes
+    float omega = 0.0f;                // Fondamental suivi (rad/échantillon)
+    float omegaNominal = 0.0f;
+    float mu = 0.0f;
+    float lastPhase = 0.0f;
+    bool phaseValid = false;
+
+    alignas(32) float oscCos[maxHarmonics] = {};
+    alignas(32) float oscSin[maxHarmonics] = {};
+    alignas(32) float weightI[maxHarmonics] = {};
+    alignas(32) float weightQ[maxHarmonics] = {};
+    alignas(32) float rotCos[maxHarmonics] = {};
+    alignas(32) float rotSin[maxHarmonics] = {};
+    alignas(32) float advCos[maxHarmonics] = {};
+    alignas(32) float advSin[maxHarmonics] = {};
+};
@@ -0,0 +1,378 @@
+#include "Trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+namespace trace {
+
+namespace detail {
+std::atomic<bool> enabled{false};
+}
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Threads tracés simultanément (au-delà, les suivants ne sont pas tracés
+// jusqu'à la fin de l'un d'eux)
+constexpr unsigned int maxThreads = 16;
+static_assert(maxThreads <= 32, "un bit par tampon dans slotsInUse");
+
+// Exports après xrun : au plus un par seconde, et un nombre limité de fichiers
+constexpr auto xrunDumpInterval = std::chrono::seconds(1);
+constexpr unsigned int maxXrunDumps = 8;
+
+struct Event {
+    int64_t time;         // Compteur de ticks (voir ticks())
+    const char* name;
+    double value;
+    EventType type;
+};
+
+struct alignas(64) ThreadBuffer {
+    std::atomic<uint64_t> writeIndex{0};
+    char name[32] = {};
+    std::vector<Event> events;  // Taille : puissance de deux
+    uint64_t mask = 0;
+    std::atomic<uint64_t> releaseOrder{0};  // 0 : jamais attribué
+};
+
+// Tampons alloués au premier enable() et conservés jusqu'à la fin du
+// processus : les pointeurs mémorisés par les threads restent valides.
+// Un tampon est rendu à la fin de son thread et réattribué ensuite, le
+// plus anciennement libéré d'abord : l'historique du thread terminé reste
+// exportable le plus longtemps possible (sur la même piste).
+std::unique_ptr<ThreadBuffer[]> buffers;
+std::atomic<uint32_t> slotsInUse{0};         // Un bit par tampon attribué
+std::atomic<unsigned int> usedBuffers{0};    // Tampons attribués au moins une fois
+std::atomic<uint64_t> releases{0};
+std::mutex setupMutex;
+
+thread_local ThreadBuffer* currentBuffer = nullptr;
+
+void releaseBuffer(void* released);
+
+// Rend le tampon du thread à sa fin. Sous POSIX, une clé pthread créée par
+// enable() : l'attribution ne fait alors qu'un pthread_setspecific, sans
+// allocation, même au premier point de trace du thread audio (un
+// thread_local à destructeur s'inscrirait par une allocation).
+#if defined(__unix__) || defined(__APPLE__)
+pthread_key_t releaseKey;
+bool releaseKeyReady = false;
+
+void registerRelease(ThreadBuffer* buffer) {
+    if (releaseKeyReady) {
+        pthread_setspecific(releaseKey, buffer);
+    }
+}
+#else
+struct SlotGuard {
+    ThreadBuffer* buffer = nullptr;
+    ~SlotGuard() {
+        if (buffer) {
+            releaseBuffer(buffer);
+        }
+    }
+};
+
+void registerRelease(ThreadBuffer* buffer) {
+    thread_local SlotGuard guard;
+    guard.buffer = buffer;
+}
+#endif
+
+// Horodatage : compteur du processeur (TSC) quand il est disponible, converti
+// en temps monotone à l'export par les deux points de référence ; sinon
+// directement l'horloge monotone en ns
+int64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return static_cast<int64_t>(__rdtsc());
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+#endif
+}
+
+struct ClockPoint {
+    int64_t ticks;
+    double ns;
+};
+
+ClockPoint clockPoint() {
+    int64_t before = ticks();
+    auto now = Clock::now();
+    int64_t after = ticks();
+    return {before + (after - before) / 2,
+            static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count())};
+}
+
+ClockPoint enableClock;
+
+std::atomic<int> pendingDump{0};
+std::string dumpPath = "noise_inverter_trace.json";
+Clock::time_point lastXrunDump;
+unsigned int xrunDumps = 0;
+
+// Attribue un tampon libre au thread courant (sans verrou : le premier point
+// de trace peut venir du thread audio). Sans tampon libre, le thread n'est
+// pas tracé ; un nouvel essai aura lieu à l'événement suivant.
+ThreadBuffer* threadBuffer() {
+    ThreadBuffer* buffer = currentBuffer;
+    if (buffer) {
+        return buffer;
+    }
+
+    uint32_t inUse = slotsInUse.load(std::memory_order_acquire);
+    for (;;) {
+        // Tampon libre le plus anciennement rendu (jamais attribué d'abord)
+        unsigned int index = maxThreads;
+        uint64_t oldest = UINT64_MAX;
+        for (unsigned int i = 0; i < maxThreads; i++) {
+            if (!(inUse & (1u << i))) {
+                uint64_t order = buffers[i].releaseOrder.load(std::memory_order_relaxed);
+                if (order < oldest) {
+                    oldest = order;
+                    index = i;
+                }
+            }
+        }
+        if (index == maxThreads) {
+            return nullptr;
+        }
+        if (slotsInUse.compare_exchange_weak(inUse, inUse | (1u << index), std::memory_order_acq_rel)) {
+            buffer = &buffers[index];
+            break;
+        }
+    }
+
+    unsigned int used = usedBuffers.load(std::memory_order_relaxed);
+    unsigned int index = static_cast<unsigned int>(buffer - buffers.get());
+    while (used <= index && !usedBuffers.compare_exchange_weak(used, index + 1, std::memory_order_release)) {
+    }
+    std::snprintf(buffer->name, sizeof(buffer->name), "thread %u", index);
+    currentBuffer = buffer;
+    registerRelease(buffer);
+    return buffer;
+}
+
+void releaseBuffer(void* released) {
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(released);
+    unsigned int index = static_cast<unsigned int>(buffer - buffers.get());
+    buffer->releaseOrder.store(releases.fetch_add(1, std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    slotsInUse.fetch_and(~(1u << index), std::memory_order_release);
+    currentBuffer = nullptr;
+}
+
+// Échappement minimal pour une chaîne JSON
+void writeJsonString(std::FILE* file, const char* text) {
+    std::fputc('"', file);
+    for (const char* p = text; *p; p++) {
+        if (*p == '"' || *p == '\\') {
+            std::fputc('\\', file);
+        }
+        if (static_cast<unsigned char>(*p) >= 0x20) {
+            std::fputc(*p, file);
+        }
+    }
+    std::fputc('"', file);
+}
+
+} // namespace
+
+namespace detail {
+
+void record(EventType type, const char* name, double value) {
+    ThreadBuffer* buffer = threadBuffer();
+    if (!buffer) {
+        return;
+    }
+    uint64_t index = buffer->writeIndex.load(std::memory_order_relaxed);
+    Event& event = buffer->events[index & buffer->mask];
+    event.time = ticks();
+    event.name = name;
+    event.value = value;
+    event.type = type;
+    buffer->writeIndex.store(index + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+bool enable(size_t eventsPerThread) {
+    std::lock_guard<std::mutex> lock(setupMutex);
+    if (!buffers) {
+        size_t capacity = 1;
+        while (capacity < eventsPerThread) {
+            capacity <<= 1;
+        }
+        enableClock = clockPoint();
+#if defined(__unix__) || defined(__APPLE__)
+        releaseKeyReady = (pthread_key_create(&releaseKey, releaseBuffer) == 0);
+#endif
+        buffers.reset(new ThreadBuffer[maxThreads]);
+        for (unsigned int i = 0; i < maxThreads; i++) {
+            buffers[i].events.assign(capacity, Event{0, "", 0.0, INSTANT});
+            buffers[i].mask = capacity - 1;
+        }
+    }
+    detail::enabled.store(true, std::memory_order_release);
+    return true;
+}
+
+void disable() {
+    detail::enabled.store(false, std::memory_order_release);
+}
+
+void setThreadName(const char* name) {
+    if (!buffers) {
+        return;
+    }
+    ThreadBuffer* buffer = threadBuffer();
+    if (buffer) {
+        std::snprintf(buffer->name, sizeof(buffer->name), "%s", name);
+    }
+}
+
+void setDumpPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(setupMutex);
+    dumpPath = path;
+}
+
+void requestDump(DumpReason reason) {
+    pendingDump.fetch_or(reason, std::memory_order_relaxed);
+}
+
+bool serviceDumps() {
+    int reasons = pendingDump.exchange(0, std::memory_order_relaxed);
+    if (reasons == 0 || !buffers) {
+        return false;
+    }
+
+    std::string path;
+    {
+        std::lock_guard<std::mutex> lock(setupMutex);
+        path = dumpPath;
+        if (!(reasons & DUMP_ON_DEMAND)) {
+            auto now = Clock::now();
+            if (xrunDumps >= maxXrunDumps || (xrunDumps > 0 && now - lastXrunDump < xrunDumpInterval)) {
+                return false;
+            }
+            lastXrunDump = now;
+            size_t dot = path.rfind(".json");
+            std::string suffix = "-xrun-" + std::to_string(++xrunDumps);
+            path = (dot == std::string::npos) ? path + suffix : path.substr(0, dot) + suffix + ".json";
+        }
+    }
+
+    bool written = dump(path);
+    if (written) {
+        std::fprintf(stderr, "Trace écrite: %s\n", path.c_str());
+    }
+    return written;
+}
+
+bool dump(const std::string& path) {
+    if (!buffers) {
+        return false;
+    }
+
+    // Copie des tampons sans arrêter les threads : les événements écrasés
+    // pendant la copie sont écartés
+    struct ThreadEvents {
+        unsigned int index;
+        std::vector<Event> events;
+    };
+    std::vector<ThreadEvents> threads;
+    int64_t origin = INT64_MAX;
+    unsigned int count = std::min(usedBuffers.load(std::memory_order_acquire), maxThreads);
+    for (unsigned int t = 0; t < count; t++) {
+        ThreadBuffer& buffer = buffers[t];
+        const uint64_t capacity = buffer.mask + 1;
+        uint64_t last = buffer.writeIndex.load(std::memory_order_acquire);
+        uint64_t first = (last > capacity) ? last - capacity : 0;
+
+        ThreadEvents copy;
+        copy.index = t;
+        copy.events.reserve(static_cast<size_t>(last - first));
+        for (uint64_t i = first; i < last; i++) {
+            copy.events.push_back(buffer.events[i & buffer.mask]);
+        }
+        uint64_t after = buffer.writeIndex.load(std::memory_order_acquire);
+        uint64_t stable = (after + 1 > capacity) ? after + 1 - capacity : 0;
+        if (stable > first) {
+            size_t skip = static_cast<size_t>(std::min<uint64_t>(stable - first, copy.events.size()));
+            copy.events.erase(copy.events.begin(), copy.events.begin() + skip);
+        }
+        if (!copy.events.empty()) {
+            origin = std::min(origin, copy.events.front().time);
+        }
+        threads.push_back(std::move(copy));
+    }
+
+    // Ticks -> µs : pente mesurée entre l'activation et l'export
+    ClockPoint exportClock = clockPoint();
+    double usPerTick = 1e-3;
+    if (exportClock.ticks > enableClock.ticks) {
+        usPerTick = (exportClock.ns - enableClock.ns) * 1e-3 / static_cast<double>(exportClock.ticks - enableClock.ticks);
+    }
+
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    for (const ThreadEvents& thread : threads) {
+        const unsigned int tid = thread.index + 1;
+        std::fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":",
+                     first ? "" : ",\n", tid);
+        writeJsonString(file, buffers[thread.index].name);
+        std::fputs("}}", file);
+        first = false;
+
+        // Une fin sans début (début écrasé) serait mal interprétée : ignorée
+        int depth = 0;
+        for (const Event& event : thread.events) {
+            double ts = static_cast<double>(event.time - origin) * usPerTick;
+            switch (event.type) {
+                case BEGIN:
+                    depth++;
+                    std::fputs(",\n{\"ph\":\"B\",\"name\":", file);
+                    writeJsonString(file, event.name);
+                    std::fprintf(file, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%g}}", tid, ts, event.value);
+                    break;
+                case END:
+                    if (depth == 0) {
+                        break;
+                    }
+                    depth--;
+                    std::fprintf(file, ",\n{\"ph\":\"E\",\"pid\":1,\"tid\":%u,\"ts\":%.3f}", tid, ts);
+                    break;
+                case INSTANT:
+                    std::fputs(",\n{\"ph\":\"i\",\"s\":\"t\",\"name\":", file);
+                    writeJsonString(file, event.name);
+                    std::fprintf(file, ",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"args\":{\"value\":%g}}", tid, ts, event.value);
+                    break;
+                case COUNTER:
+                    std::fputs(",\n{\"ph\":\"C\",\"name\":", file);
+                    writeJsonString(file, event.name);
+                    std::fprintf(file, ",\"pid\":1,\"ts\":%.3f,\"args\":{\"value\":%g}}", ts, event.value);
+                    break;
+            }
+        }
+    }
+    std::fputs("\n]}\n", file);
+    return std::fclose(file) == 0;
+}
+
+} // namespace trace
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Traçage chronologique du traitement, exportable au format Chrome trace
+// (JSON, lisible par chrome://tracing et Perfetto).
+//
+// Chaque thread écrit dans son propre tampon circulaire (producteur unique,
+// sans verrou ni allocation) : débuts et fins de sections, événements
+// ponctuels et compteurs, datés par le compteur du processeur (converti à
+// l'export) ou à défaut par l'horloge monotone. Les tampons sont
+// alloués une fois pour toutes par enable() ; le plus ancien est écrasé,
+// il reste donc toujours les dernières secondes de chaque thread. Un
+// tampon est rendu à la fin de son thread et réattribué aux threads
+// suivants (réouvertures du flux).
+//
+// L'export se fait hors du thread audio : à la demande (dump(), signal
+// SIGUSR1 côté application) ou après un xrun, via requestDump() qui se
+// contente de lever un drapeau, traité par serviceDumps() sur un thread
+// ordinaire. Désactivé, chaque point de trace coûte un chargement atomique.
+namespace trace {
+
+enum EventType : uint8_t {
+    BEGIN = 0,
+    END = 1,
+    INSTANT = 2,
+    COUNTER = 3
+};
+
+enum DumpReason {
+    DUMP_ON_DEMAND = 1,
+    DUMP_ON_XRUN = 2
+};
+
+namespace detail {
+extern std::atomic<bool> enabled;
+void record(EventType type, const char* name, double value);
+} // namespace detail
+
+// Allocation des tampons (premier appel) et activation. Hors du thread audio.
+bool enable(size_t eventsPerThread = 16384);
+void disable();
+inline bool isEnabled() { return detail::enabled.load(std::memory_order_relaxed); }
+
+// Nom du thread courant dans la trace (copié, appel hors temps réel de préférence)
+void setThreadName(const char* name);
+
+// Points de trace (noms : chaînes littérales, conservées par pointeur)
+inline void begin(const char* name, double value = 0.0) {
+    if (isEnabled()) detail::record(BEGIN, name, value);
+}
+inline void end(const char* name) {
+    if (isEnabled()) detail::record(END, name, 0.0);
+}
+inline void instant(const char* name, double value = 0.0) {
+    if (isEnabled()) detail::record(INSTANT, name, value);
+}
+inline void counter(const char* name, double value) {
+    if (isEnabled()) detail::record(COUNTER, name, value);
+}
+
+// Section délimitée par la portée ; value est exportée comme argument
+class Scope {
+public:
+    explicit Scope(const char* name, double value = 0.0) : name(isEnabled() ? name : nullptr) {
+        if (this->name) detail::record(BEGIN, name, value);
+    }
+    ~Scope() {
+        if (name) detail::record(END, name, 0.0);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    const char* name;
+};
+
+// Export : chemin des fichiers produits par serviceDumps() (les exports
+// après xrun reçoivent le suffixe -xrun-N)
+void setDumpPath(const std::string& path);
+void requestDump(DumpReason reason);  // Utilisable depuis le thread audio ou un signal
+bool serviceDumps();                  // Thread ordinaire ; vrai si un fichier a été écrit
+bool dump(const std::string& path);
+
+} // namespace trace
+
+#define NI_TRACE_CONCAT_(a, b) a##b
+#define NI_TRACE_CONCAT(a, b) NI_TRACE_CONCAT_(a, b)
+#define NI_TRACE_SCOPE(...) trace::Scope NI_TRACE_CONCAT(niTraceScope_, __LINE__)(__VA_ARGS__)
+#define NI_TRACE_INSTANT(...) trace::instant(__VA_ARGS__)
+#define NI_TRACE_COUNTER(name, value) trace::counter(name, value)
@@ -0,0 +1,477 @@
+#include "ZoneHost.h"
+#include "NullBackend.h"
+#include "RealtimeAudit.h"
+#include "Trace.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Attente active avant de s'endormir, pour un thread de travail entre deux
+// blocs (un réveil par le noyau coûte plusieurs dizaines de microsecondes)
+constexpr auto workerSpin = std::chrono::microseconds(50);
+
+// Priorité SCHED_FIFO des threads de travail
+constexpr int workerPriority = 70;
+
+// Lissage de la durée moyenne des travaux (par bloc)
+constexpr double costSmoothing = 0.05;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+// Intervalle [début, fin) d'une liste de travaux, dans un seul mot
+inline uint64_t packRange(uint32_t begin, uint32_t end) {
+    return (static_cast<uint64_t>(end) << 32) | begin;
+}
+
+#ifdef __linux__
+void futexWait(std::atomic<uint32_t>& word, uint32_t expected) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void futexWakeAll(std::atomic<uint32_t>& word) {
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+#endif
+
+} // namespace
+
+ZoneHost::ZoneHost(std::unique_ptr<AudioBackend> audioBackend)
+    : backend(std::move(audioBackend)) {
+}
+
+ZoneHost::~ZoneHost() {
+    stop();
+}
+
+// Les moteurs des zones n'ouvrent aucun flux : un backend nul leur suffit
+size_t ZoneHost::addZone(const ZoneConfig& config) {
+    if (running) {
+        return zones.size();
+    }
+    auto zone = std::make_unique<Zone>();
+    zone->engine = std::make_unique<NoiseInverter>(std::make_unique<NullBackend>());
+    zone->config = config;
+    zone->config.inputChannels = std::max(1u, std::min(2u, config.inputChannels));
+    zone->config.outputChannels = std::max(1u, std::min(2u, config.outputChannels));
+    zones.push_back(std::move(zone));
+    return zones.size() - 1;
+}
+
+bool ZoneHost::start(int inputDevice, int outputDevice) {
+    if (running) {
+        return true;
+    }
+    if (zones.empty() || !backend) {
+        return false;
+    }
+
+    // Voies consécutives pour chaque zone, dans l'ordre d'ajout
+    streamConfig = StreamConfig();
+    streamConfig.inputDevice = inputDevice;
+    streamConfig.outputDevice = outputDevice;
+    streamConfig.inputChannels = 0;
+    streamConfig.outputChannels = 0;
+    for (auto& zone : zones) {
+        zone->inputOffset = streamConfig.inputChannels;
+        zone->outputOffset = streamConfig.outputChannels;
+        streamConfig.inputChannels += zone->config.inputChannels;
+        streamConfig.outputChannels += zone->config.outputChannels;
+    }
+    streamConfig.bufferFrames = bufferFrames;
+    streamConfig.streamName = "NoiseInverter (zones)";
+
+    if (!backend->open(streamConfig, &audioCallback, this)) {
+        std::cerr << "Erreur: impossible d'ouvrir le stream audio" << std::endl;
+        return false;
+    }
+    bufferFrames = streamConfig.bufferFrames;
+    realtimeBackend = backend->isRealtime();
+
+    for (auto& zone : zones) {
+        zone->engine->prepareHosted(streamConfig.sampleRate, bufferFrames,
+                                    zone->config.inputChannels, zone->config.outputChannels);
+        zone->input.assign(static_cast<size_t>(bufferFrames) * zone->config.inputChannels, 0.0f);
+        zone->output.assign(static_cast<size_t>(bufferFrames) * zone->config.outputChannels, 0.0f);
+        zone->cost = 0.0;
+    }
+
+    // Un thread par cœur au plus, et pas plus que de zones
+    unsigned int count = requestedWorkers;
+    if (count == 0) {
+        count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    count = std::max(1u, std::min(count, static_cast<unsigned int>(zones.size())));
+
+    queues.clear();
+    for (unsigned int w = 0; w < count; w++) {
+        auto queue = std::make_unique<WorkQueue>();
+        queue->jobs.assign(zones.size(), 0);
+        queues.push_back(std::move(queue));
+    }
+    order.resize(zones.size());
+    for (unsigned int i = 0; i < zones.size(); i++) {
+        order[i] = i;
+    }
+    plannedCost.assign(count, 0.0);
+    plannedJobs.assign(count, 0);
+
+    quit = false;
+    bool priorityDenied = false;
+    for (unsigned int w = 1; w < count; w++) {
+        workers.emplace_back(&ZoneHost::workerThread, this, w);
+#ifdef __linux__
+        // Épinglage sur le w-ième cœur autorisé, puis priorité temps réel
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0 && CPU_COUNT(&allowed) > 0) {
+            int target = static_cast<int>(w % CPU_COUNT(&allowed));
+            for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+                if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+                    cpu_set_t pinned;
+                    CPU_ZERO(&pinned);
+                    CPU_SET(cpu, &pinned);
+                    pthread_setaffinity_np(workers.back().native_handle(), sizeof(pinned), &pinned);
+                    break;
+                }
+            }
+        }
+        sched_param param{};
+        param.sched_priority = std::min(workerPriority, sched_get_priority_max(SCHED_FIFO));
+        if (pthread_setschedparam(workers.back().native_handle(), SCHED_FIFO, &param) != 0) {
+            priorityDenied = true;
+        }
+#endif
+    }
+    if (priorityDenied) {
+        std::cerr << "Priorité temps réel refusée pour les threads de zone" << std::endl;
+    }
+
+    blockCount = 0;
+    missedDeadlines = 0;
+    stealCount = 0;
+    maxBlockLoad = 0.0;
+
+    running = true;
+    if (!backend->start()) {
+        std::cerr << "Erreur: impossible de démarrer le stream audio" << std::endl;
+        stop();
+        return false;
+    }
+
+    std::cout << "Hôte multizone démarré: " << zones.size() << " zone(s), "
+              << count << " thread(s) de travail, " << streamConfig.inputChannels << " entrée(s), "
+              << streamConfig.outputChannels << " sortie(s), tampon " << bufferFrames
+              << " échantillons" << std::endl;
+    return true;
+}
+
+void ZoneHost::stop() {
+    if (!running) {
+        return;
+    }
+    running = false;
+    backend->stop();
+    backend->close();
+
+    quit = true;
+    epoch.fetch_add(1);
+#ifdef __linux__
+    futexWakeAll(epoch);
+#endif
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    for (auto& zone : zones) {
+        zone->engine->releaseHosted();
+    }
+}
+
+bool ZoneHost::isStreamFinished() const {
+    return backend && backend->isFinished();
+}
+
+ZoneHost::ZoneLoad ZoneHost::getZoneLoad(size_t index) {
+    Zone& zone = *zones[index];
+    ZoneLoad load;
+    load.averageLoad = zone.averageLoad.load(std::memory_order_relaxed);
+    load.maxLoad = zone.maxLoad.exchange(0.0, std::memory_order_relaxed);
+    load.blocks = zone.blocks.load(std::memory_order_relaxed);
+    load.lateBlocks = zone.lateBlocks.load(std::memory_order_relaxed);
+    load.shedBlocks = zone.shedBlocks.load(std::memory_order_relaxed);
+    return load;
+}
+
+ZoneHost::Stats ZoneHost::getStats() const {
+    Stats stats;
+    stats.blocks = blockCount.load(std::memory_order_relaxed);
+    stats.missedDeadlines = missedDeadlines.load(std::memory_order_relaxed);
+    stats.steals = stealCount.load(std::memory_order_relaxed);
+    stats.maxLoad = maxBlockLoad.load(std::memory_order_relaxed);
+    stats.workers = static_cast<unsigned int>(queues.size());
+    return stats;
+}
+
+// Callback audio : les blocs plus longs que prévu sont traités en plusieurs fois
+int ZoneHost::audioCallback(float* output, const float* input, unsigned int nFrames,
+                            double streamTime, unsigned int status, void* userData) {
+    NI_RT_SECTION();
+    NI_TRACE_SCOPE("callback", nFrames);
+    if (status != STREAM_OK) {
+        NI_TRACE_INSTANT("xrun", status);
+        trace::requestDump(trace::DUMP_ON_XRUN);
+    }
+
+    ZoneHost* self = static_cast<ZoneHost*>(userData);
+    const unsigned int inputChannels = self->streamConfig.inputChannels;
+    const unsigned int outputChannels = self->streamConfig.outputChannels;
+    for (unsigned int done = 0; done < nFrames; done += self->bufferFrames) {
+        unsigned int count = std::min(self->bufferFrames, nFrames - done);
+        self->processBlock(output + static_cast<size_t>(done) * outputChannels,
+                           input + static_cast<size_t>(done) * inputChannels, count);
+    }
+    return 0;
+}
+
+// Un bloc : publication des travaux, participation du callback, attente des
+// travaux commencés par les autres threads, puis réentrelacement des sorties
+void ZoneHost::processBlock(float* output, const float* input, unsigned int nFrames) {
+    const auto begin = Clock::now();
+    const double period = static_cast<double>(nFrames) / streamConfig.sampleRate;
+
+    blockInput = input;
+    blockFrames = nFrames;
+    blockDeadline = begin + std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(period * deadlineFraction));
+    shedding = realtimeBackend;
+
+    distributeJobs();
+    wakeWorkers();
+    runJobs(0);
+
+    // Ne restent que des travaux en cours sur d'autres threads
+    for (unsigned int spins = 1; pending.load(std::memory_order_acquire) != 0; spins++) {
+        cpuRelax();
+        if (spins % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    const unsigned int outputChannels = streamConfig.outputChannels;
+    for (auto& zonePtr : zones) {
+        Zone& zone = *zonePtr;
+        const unsigned int channels = zone.config.outputChannels;
+        float* out = output + zone.outputOffset;
+        if (zone.shed) {
+            for (unsigned int i = 0; i < nFrames; i++) {
+                std::memset(out + static_cast<size_t>(i) * outputChannels, 0, channels * sizeof(float));
+            }
+            zone.shedBlocks.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        for (unsigned int i = 0; i < nFrames; i++) {
+            for (unsigned int c = 0; c < channels; c++) {
+                out[static_cast<size_t>(i) * outputChannels + c] = zone.output[i * channels + c];
+            }
+        }
+
+        // Charge de la zone relative à la période
+        zone.cost = (zone.cost == 0.0) ? zone.duration : zone.cost + costSmoothing * (zone.duration - zone.cost);
+        double load = zone.duration / period;
+        zone.averageLoad.store(zone.cost / period, std::memory_order_relaxed);
+        if (load > zone.maxLoad.load(std::memory_order_relaxed)) {
+            zone.maxLoad.store(load, std::memory_order_relaxed);
+        }
+        zone.blocks.fetch_add(1, std::memory_order_relaxed);
+        if (zone.late) {
+            zone.lateBlocks.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    const auto end = Clock::now();
+    double blockLoad = std::chrono::duration<double>(end - begin).count() / period;
+    if (blockLoad > maxBlockLoad.load(std::memory_order_relaxed)) {
+        maxBlockLoad.store(blockLoad, std::memory_order_relaxed);
+    }
+    if (end > blockDeadline) {
+        missedDeadlines.fetch_add(1, std::memory_order_relaxed);
+        NI_TRACE_INSTANT("échéance manquée", blockLoad);
+    }
+    blockCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Répartition gloutonne : chaque zone, de la plus coûteuse à la moins
+// coûteuse, va au thread dont la charge prévue est la plus faible
+void ZoneHost::distributeJobs() {
+    // Tri par insertion : l'ordre change peu d'un bloc à l'autre
+    for (size_t i = 1; i < order.size(); i++) {
+        unsigned int index = order[i];
+        size_t j = i;
+        while (j > 0 && zones[order[j - 1]]->cost < zones[index]->cost) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = index;
+    }
+
+    const unsigned int count = static_cast<unsigned int>(queues.size());
+    std::fill(plannedCost.begin(), plannedCost.end(), 0.0);
+    std::fill(plannedJobs.begin(), plannedJobs.end(), 0u);
+    for (unsigned int index : order) {
+        unsigned int best = 0;
+        for (unsigned int w = 1; w < count; w++) {
+            if (plannedCost[w] < plannedCost[best]) {
+                best = w;
+            }
+        }
+        queues[best]->jobs[plannedJobs[best]++] = index;
+        // Coût minimal : des zones encore jamais mesurées sont réparties en tourniquet
+        plannedCost[best] += zones[index]->cost + 1e-9;
+    }
+
+    pending.store(static_cast<unsigned int>(zones.size()), std::memory_order_relaxed);
+    for (unsigned int w = 0; w < count; w++) {
+        queues[w]->range.store(packRange(0, plannedJobs[w]), std::memory_order_release);
+    }
+}
+
+// Travaux de la liste du thread, puis vol dans celles des autres
+void ZoneHost::runJobs(unsigned int worker) {
+    unsigned int zoneIndex = 0;
+    while (takeJob(worker, false, zoneIndex)) {
+        runJob(zoneIndex);
+    }
+
+    const unsigned int count = static_cast<unsigned int>(queues.size());
+    for (unsigned int k = 1; k < count; k++) {
+        unsigned int victim = (worker + k) % count;
+        while (takeJob(victim, true, zoneIndex)) {
+            stealCount.fetch_add(1, std::memory_order_relaxed);
+            runJob(zoneIndex);
+        }
+    }
+}
+
+bool ZoneHost::takeJob(unsigned int queue, bool steal, unsigned int& zoneIndex) {
+    WorkQueue& work = *queues[queue];
+    uint64_t range = work.range.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t first = static_cast<uint32_t>(range);
+        uint32_t last = static_cast<uint32_t>(range >> 32);
+        if (first >= last) {
+            return false;
+        }
+        uint64_t next = steal ? packRange(first, last - 1) : packRange(first + 1, last);
+        if (work.range.compare_exchange_weak(range, next, std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+            zoneIndex = work.jobs[steal ? last - 1 : first];
+            return true;
+        }
+    }
+}
+
+// Traite une zone, ou l'abandonne si l'échéance est déjà passée
+void ZoneHost::runJob(unsigned int zoneIndex) {
+    Zone& zone = *zones[zoneIndex];
+    const unsigned int nFrames = blockFrames;
+    const auto begin = Clock::now();
+
+    if (shedding && begin > blockDeadline) {
+        zone.shed = true;
+        zone.late = false;
+        zone.duration = 0.0;
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+        NI_TRACE_INSTANT("zone abandonnée", zoneIndex);
+        return;
+    }
+    NI_TRACE_SCOPE("zone", zoneIndex);
+
+    // Voies de la zone extraites du flux entrelacé
+    const unsigned int streamChannels = streamConfig.inputChannels;
+    const unsigned int channels = zone.config.inputChannels;
+    const float* in = blockInput + zone.inputOffset;
+    for (unsigned int i = 0; i < nFrames; i++) {
+        for (unsigned int c = 0; c < channels; c++) {
+            zone.input[i * channels + c] = in[static_cast<size_t>(i) * streamChannels + c];
+        }
+    }
+
+    zone.engine->processHosted(zone.output.data(), zone.input.data(), nFrames);
+
+    const auto end = Clock::now();
+    zone.shed = false;
+    zone.late = end > blockDeadline;
+    zone.duration = std::chrono::duration<double>(end - begin).count();
+    pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+void ZoneHost::wakeWorkers() {
+    epoch.fetch_add(1);
+#ifdef __linux__
+    // Appel système seulement si un thread s'est endormi
+    if (sleepers.load() != 0) {
+        futexWakeAll(epoch);
+    }
+#endif
+}
+
+// Attente du bloc suivant : active d'abord, puis endormi sur l'époque
+void ZoneHost::waitForBlock(uint32_t seenEpoch) {
+    const auto spinEnd = Clock::now() + workerSpin;
+    while (epoch.load(std::memory_order_acquire) == seenEpoch) {
+        if (Clock::now() < spinEnd) {
+            cpuRelax();
+            continue;
+        }
+#ifdef __linux__
+        sleepers.fetch_add(1);
+        if (epoch.load() == seenEpoch) {
+            futexWait(epoch, seenEpoch);
+        }
+        sleepers.fetch_sub(1);
+#else
+        std::this_thread::yield();
+#endif
+    }
+}
+
+void ZoneHost::workerThread(unsigned int worker) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "zones %u", worker);
+    trace::setThreadName(name);
+
+    uint32_t seen = epoch.load(std::memory_order_acquire);
+    while (true) {
+        waitForBlock(seen);
+        seen = epoch.load(std::memory_order_acquire);
+        if (quit.load(std::memory_order_acquire)) {
+            break;
+        }
+
+        NI_RT_SECTION();
+        runJobs(worker);
+    }
+}
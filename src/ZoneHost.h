@@ -0,0 +1,152 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include "NoiseInverter.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Hôte multizone : plusieurs chaînes d'annulation indépendantes (canaux,
+// paramètres et mode propres) partagent un seul flux audio.
+//
+// Les voies du périphérique sont attribuées aux zones dans l'ordre de leur
+// ajout. À chaque bloc, le callback publie un travail par zone pour un
+// groupe de threads de travail temps réel, épinglés chacun sur un cœur ;
+// le callback est lui-même l'un de ces threads. Les travaux sont répartis
+// d'après leur coût mesuré aux blocs précédents, les plus longs d'abord ;
+// un thread qui a vidé sa liste vole les derniers travaux des autres.
+// Ni verrou ni allocation : listes et compteurs sont dimensionnés au
+// démarrage.
+//
+// Échéance commune : une fraction de la période du bloc. Sur un backend
+// temps réel, un travail qui n'a pas commencé à l'échéance est abandonné
+// (zone muette pour ce bloc) plutôt que de faire manquer le bloc à toutes
+// les zones ; un travail commencé est toujours attendu.
+class ZoneHost {
+public:
+    struct ZoneConfig {
+        unsigned int inputChannels = 1;   // 2 : micro d'erreur (mode hybride)
+        unsigned int outputChannels = 2;  // 1 ou 2
+    };
+
+    // Charge d'une zone, en fraction de la période du bloc
+    struct ZoneLoad {
+        double averageLoad;         // Moyenne glissante
+        double maxLoad;             // Maximum depuis la lecture précédente
+        uint64_t blocks;
+        uint64_t lateBlocks;        // Terminés après l'échéance
+        uint64_t shedBlocks;        // Abandonnés à l'échéance
+    };
+
+    struct Stats {
+        uint64_t blocks;
+        uint64_t missedDeadlines;   // Blocs terminés après l'échéance
+        uint64_t steals;            // Travaux exécutés par un autre thread que prévu
+        double maxLoad;             // Durée maximale d'un bloc / période
+        unsigned int workers;       // Threads de travail, callback compris
+    };
+
+    explicit ZoneHost(std::unique_ptr<AudioBackend> backend);
+    ~ZoneHost();
+
+    // Flux arrêté uniquement. Retourne l'indice de la zone.
+    size_t addZone(const ZoneConfig& config);
+    size_t zoneCount() const { return zones.size(); }
+    NoiseInverter& zone(size_t index) { return *zones[index]->engine; }
+
+    // Réglages pris en compte au prochain démarrage.
+    // workers = 0 : un par cœur, sans dépasser le nombre de zones.
+    void setWorkerCount(unsigned int count) { if (!running) requestedWorkers = count; }
+    void setBufferFrames(unsigned int frames) { if (!running) bufferFrames = frames; }
+    void setDeadlineFraction(double fraction) { if (!running) deadlineFraction = fraction; }
+
+    bool start(int inputDevice, int outputDevice);
+    void stop();
+    bool isRunning() const { return running; }
+    bool isStreamFinished() const;
+
+    // Lecture de la charge d'une zone (remet son maximum à zéro)
+    ZoneLoad getZoneLoad(size_t index);
+    Stats getStats() const;
+
+private:
+    struct alignas(64) Zone {
+        std::unique_ptr<NoiseInverter> engine;
+        ZoneConfig config;
+        unsigned int inputOffset = 0;    // Première voie dans le flux
+        unsigned int outputOffset = 0;
+        std::vector<float> input;        // Voies de la zone, entrelacées
+        std::vector<float> output;
+
+        // Résultat du dernier travail (publié par la décrémentation de pending)
+        double duration = 0.0;           // Secondes
+        bool late = false;
+        bool shed = false;
+
+        // Thread du callback
+        double cost = 0.0;               // Durée moyenne, pour la répartition
+
+        // Statistiques
+        std::atomic<double> averageLoad{0.0};
+        std::atomic<double> maxLoad{0.0};
+        std::atomic<uint64_t> blocks{0};
+        std::atomic<uint64_t> lateBlocks{0};
+        std::atomic<uint64_t> shedBlocks{0};
+    };
+
+    // Liste de travaux d'un thread : indices de zones, et intervalle restant
+    // [début, fin) dans un seul mot. Le propriétaire prend au début, les
+    // voleurs à la fin, tous par compare-and-swap.
+    struct alignas(64) WorkQueue {
+        std::vector<unsigned int> jobs;
+        std::atomic<uint64_t> range{0};
+    };
+
+    static int audioCallback(float* output, const float* input, unsigned int nFrames,
+                             double streamTime, unsigned int status, void* userData);
+    void processBlock(float* output, const float* input, unsigned int nFrames);
+
+    void distributeJobs();
+    void runJobs(unsigned int worker);
+    bool takeJob(unsigned int queue, bool steal, unsigned int& zoneIndex);
+    void runJob(unsigned int zoneIndex);
+
+    void workerThread(unsigned int worker);
+    void wakeWorkers();
+    void waitForBlock(uint32_t seenEpoch);
+
+    std::unique_ptr<AudioBackend> backend;
+    StreamConfig streamConfig;
+    std::vector<std::unique_ptr<Zone>> zones;
+    unsigned int bufferFrames = 128;
+    unsigned int requestedWorkers = 0;
+    double deadlineFraction = 0.8;
+    std::atomic<bool> running{false};
+
+    // Groupe de threads (le thread 0 est celui du callback)
+    std::vector<std::unique_ptr<WorkQueue>> queues;
+    std::vector<std::thread> workers;
+    std::vector<unsigned int> order;     // Zones par coût décroissant
+    std::vector<double> plannedCost;     // Par thread, pendant la répartition
+    std::vector<unsigned int> plannedJobs;
+    alignas(64) std::atomic<uint32_t> epoch{0};
+    std::atomic<unsigned int> sleepers{0};
+    std::atomic<bool> quit{false};
+    alignas(64) std::atomic<unsigned int> pending{0};
+
+    // Bloc courant (écrit avant la publication des travaux)
+    const float* blockInput = nullptr;
+    unsigned int blockFrames = 0;
+    std::chrono::steady_clock::time_point blockDeadline;
+    bool shedding = false;
+    bool realtimeBackend = true;
+
+    // Statistiques
+    std::atomic<uint64_t> blockCount{0};
+    std::atomic<uint64_t> missedDeadlines{0};
+    std::atomic<uint64_t> stealCount{0};
+    std::atomic<double> maxBlockLoad{0.0};
+};
@@ -1,5 +1,17 @@
 #include "NoiseInverter.h"
+#include "RealtimeAudit.h"
+#include "FileBackend.h"
+#include "NullBackend.h"
+#include "PipeBackend.h"
+#include "RtAudioBackend.h"
+#include "SplitDeviceBackend.h"
+#include "Trace.h"
+#include "ZoneHost.h"
+#include <atomic>
+#include <cmath>
+#include <csignal>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <thread>
@@ -13,16 +25,647 @@ void afficherMenu() {
     std::cout << "3. Calibrer\n";
     std::cout << "4. Modifier les paramètres\n";
     std::cout << "5. Arrêter\n";
+    std::cout << "6. Mode tonal / large bande\n";
     std::cout << "0. Quitter\n";
     std::cout << "Votre choix: ";
 }
 
-int main() {
+// Mode simulation : traite des blocs synthétiques sans périphérique.
+// Retourne un code d'erreur si l'audit temps réel a détecté des violations.
+int lancerSimulation(unsigned int blocs) {
+    NoiseInverter inverter;
+    
+    std::cout << "Simulation de " << blocs << " blocs...\n";
+    if (!inverter.runSimulation(blocs)) {
+        std::cout << "Échec de la simulation.\n";
+        return 1;
+    }
+    
+    if (!rtaudit::isEnabled()) {
+        std::cout << "Simulation terminée (audit temps réel non compilé).\n";
+        return 0;
+    }
+    
+    size_t violations = rtaudit::violationCount();
+    size_t allocations = inverter.getSimulationAllocations();
+    std::cout << "Simulation terminée : " << violations << " violation(s) temps réel, "
+              << allocations << " allocation(s) sur le tas en régime établi.\n";
+    return (violations == 0 && allocations == 0) ? 0 : 1;
+}
+
+// Audit d'un flux réel : start() puis stop() sur le backend nul cadencé,
+// dans chaque mode. Entre le retour de start() et l'appel de stop(), aucune
+// allocation sur le tas (tous threads) ni violation temps réel n'est tolérée.
+int lancerAuditFlux(unsigned int blocs) {
+    if (!rtaudit::isEnabled()) {
+        std::cout << "Audit temps réel non compilé.\n";
+        return 0;
+    }
+    
+    static const NoiseInverter::EngineMode modes[3] = {NoiseInverter::BROADBAND, NoiseInverter::TONAL,
+                                                       NoiseInverter::HYBRID};
+    static const char* nomsModes[3] = {"large bande", "tonal", "hybride"};
+    int echecs = 0;
+    for (int i = 0; i < 3; i++) {
+        NoiseInverter inverter(std::make_unique<NullBackend>(NullBackend::NOISE, true, blocs));
+        inverter.setProfileLoading(false);
+        inverter.setMeteringEnabled(true);
+        inverter.setEngineMode(modes[i]);
+        if (!inverter.start(-1, -1)) {
+            echecs++;
+            continue;
+        }
+        
+        size_t violations = rtaudit::violationCount();
+        size_t allocations = rtaudit::allocationCount();
+        while (!inverter.isStreamFinished()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        violations = rtaudit::violationCount() - violations;
+        allocations = rtaudit::allocationCount() - allocations;
+        inverter.stop();
+        
+        std::cout << "Flux " << nomsModes[i] << " : " << blocs << " blocs, " << violations
+                  << " violation(s) temps réel, " << allocations << " allocation(s) entre start() et stop()\n";
+        if (violations != 0 || allocations != 0) {
+            echecs++;
+        }
+    }
+    return echecs == 0 ? 0 : 1;
+}
+
+// Compare les chaînes large bande flottante et virgule fixe : exactitude
+// au bit près, plancher de bruit et débit
+int lancerComparaisonVirguleFixe(unsigned int blocs) {
+    NoiseInverter inverter(std::make_unique<NullBackend>());
+    inverter.setParameters(5.0f, 0.9f);
+    
+    static const char* nomsFiltres[3] = {"passe-bande", "passe-bas", "passe-haut"};
+    std::cout << "Comparaison flottant / virgule fixe sur " << blocs << " blocs"
+#ifdef NOISE_INVERTER_FIXED_POINT
+              << " (moteur compilé en virgule fixe)"
+#endif
+              << ":\n";
+    for (const auto& resultat : inverter.compareFixedPoint(blocs)) {
+        std::cout << "  " << nomsFiltres[resultat.filterType] << ": "
+                  << resultat.exactRatio * 100.0 << " % identiques au bit près"
+                  << ", écart max " << resultat.maxErrorLsb << " LSB"
+                  << ", plancher de bruit " << resultat.noiseFloorDb << " dBFS"
+                  << ", flottant " << resultat.floatNsPerFrame << " ns/trame"
+                  << ", virgule fixe " << resultat.fixedNsPerFrame << " ns/trame\n";
+    }
+    return 0;
+}
+
+// Attend une reprise de plus que `reprises` (au plus `delaiMs`)
+bool attendreReprise(const NoiseInverter& inverter, uint64_t reprises, unsigned int delaiMs) {
+    auto echeance = std::chrono::steady_clock::now() + std::chrono::milliseconds(delaiMs);
+    while (std::chrono::steady_clock::now() < echeance) {
+        if (inverter.getWatchdogStats().recoveries > reprises) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    return false;
+}
+
+// Niveau RMS moyen de la sortie sur une courte durée
+float mesurerNiveau(const NoiseInverter& inverter) {
+    float somme = 0.0f;
+    for (int i = 0; i < 20; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        somme += inverter.getOutputRms();
+    }
+    return somme / 20.0f;
+}
+
+// Vérifie la surveillance du flux : blocages et pertes du périphérique
+// injectés sur le backend nul, reprise automatique dans le délai borné,
+// premier bloc rouvert en fondu d'entrée (début quasi silencieux), niveau
+// de sortie (donc paramètres) identique avant et après chaque panne
+int lancerVerificationSurveillance(unsigned int cycles) {
+    auto backend = std::make_unique<NullBackend>(NullBackend::NOISE);
+    NullBackend* backendNul = backend.get();
+    NoiseInverter inverter(std::move(backend));
+    inverter.setProfileLoading(false);
+    inverter.setMeteringEnabled(true);
+    inverter.setParameters(3.0f, 0.5f, 200.0f, 1500.0f, NoiseInverter::LOWPASS);
+    if (!inverter.start(-1, -1)) {
+        return 1;
+    }
+    
+    // Borne de reprise : détection (blocage) + réouverture, avec marge
+    const unsigned int borneMs = 1500;
+    int echecs = 0;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    float niveauInitial = mesurerNiveau(inverter);
+    
+    for (unsigned int cycle = 0; cycle < cycles; cycle++) {
+        struct Panne { const char* nom; unsigned int ouverturesRefusees; bool blocage; };
+        const Panne pannes[3] = {
+            {"blocage du callback", 0, true},
+            {"perte du périphérique", 0, false},
+            {"perte du périphérique, 3 ouvertures refusées", 3, false}
+        };
+        for (const Panne& panne : pannes) {
+            uint64_t reprises = inverter.getWatchdogStats().recoveries;
+            uint64_t callbacks = backendNul->getStats().callbacks;
+            if (panne.blocage) {
+                backendNul->injectStall(2000);
+            } else {
+                backendNul->injectDeviceLoss(panne.ouverturesRefusees);
+            }
+            
+            bool reprise = attendreReprise(inverter, reprises, borneMs);
+            NoiseInverter::WatchdogStats stats = inverter.getWatchdogStats();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            NullBackend::Stats premierBloc = backendNul->getStats();
+            float niveau = mesurerNiveau(inverter);
+            bool niveauConserve = std::abs(niveau - niveauInitial) <= 0.2f * niveauInitial;
+            bool callbacksRepris = premierBloc.callbacks > callbacks;
+            bool fonduEntree = premierBloc.startHeadRms < 0.3 * niveauInitial &&
+                               premierBloc.startHeadRms < premierBloc.startTailRms;
+            
+            std::cout << "  " << panne.nom << " : ";
+            if (reprise) {
+                std::cout << "reprise en " << stats.lastRecoveryMs << " ms";
+            } else {
+                std::cout << "pas de reprise";
+            }
+            std::cout << ", premier bloc " << premierBloc.startHeadRms << " -> " << premierBloc.startTailRms
+                      << ", niveau de sortie " << niveau << " (initial " << niveauInitial << ")\n";
+            if (!reprise || !callbacksRepris || !fonduEntree || !niveauConserve || !inverter.isRunning()) {
+                echecs++;
+            }
+        }
+    }
+    
+    inverter.stop();
+    NoiseInverter::WatchdogStats stats = inverter.getWatchdogStats();
+    std::cout << "Surveillance : " << stats.stalls << " blocage(s), " << stats.deviceLosses
+              << " perte(s) du périphérique, " << stats.recoveries << " reprise(s)"
+              << ", " << stats.failedRecoveries << " abandon(s)"
+              << ", reprise moyenne " << (stats.recoveries ? stats.totalRecoveryMs / stats.recoveries : 0.0)
+              << " ms, max " << stats.maxRecoveryMs << " ms (borne " << borneMs << " ms)\n";
+    if (stats.maxRecoveryMs > borneMs) {
+        echecs++;
+    }
+    std::cout << (echecs == 0 ? "Vérification réussie" : "Vérification échouée")
+              << " (" << echecs << " échec(s))\n";
+    return echecs == 0 ? 0 : 1;
+}
+
+// Simulation acoustique du mode hybride, bloc par bloc : la perturbation
+// au micro d'erreur est le bruit de référence retardé et filtré (chemin
+// primaire), à laquelle s'ajoute la sortie du moteur retardée de deux blocs
+// (chemin secondaire). Retourne l'atténuation mesurée sur les derniers blocs
+// (dB, puissance d'erreur / puissance de la perturbation seule).
+struct SimulationAcoustique {
+    static constexpr unsigned int trames = 32;
+    static constexpr unsigned int retardPrimaire = 2 * trames + 24;
+    static constexpr unsigned int retardSecondaire = 2 * trames;
+    static constexpr float gainSecondaire = 0.9f;   // Le modèle du moteur suppose 1 : erreur de modèle
+    
+    std::vector<float> reference = std::vector<float>(retardPrimaire + 1, 0.0f);
+    std::vector<float> sorties = std::vector<float>(retardSecondaire, 0.0f);
+    unsigned int etatBruit = 4242u;
+    float passeBas = 0.0f;
+    
+    double traiter(NoiseInverter& inverter, unsigned int blocs, unsigned int blocsMesures) {
+        std::vector<float> entree(2 * trames), sortie(2 * trames);
+        double puissanceErreur = 0.0, puissancePerturbation = 0.0;
+        for (unsigned int bloc = 0; bloc < blocs; bloc++) {
+            for (unsigned int n = 0; n < trames; n++) {
+                etatBruit = etatBruit * 1664525u + 1013904223u;
+                float x = (static_cast<int32_t>(etatBruit) / 2147483648.0f) * 0.5f;
+                reference.erase(reference.begin());
+                reference.push_back(x);
+                passeBas += 0.3f * (reference.front() - passeBas);
+                float perturbation = 0.8f * passeBas;
+                float antibruit = gainSecondaire * sorties[n];
+                float erreur = perturbation + antibruit;
+                entree[2 * n] = x;
+                entree[2 * n + 1] = erreur;
+                if (bloc + blocsMesures >= blocs) {
+                    puissanceErreur += erreur * erreur;
+                    puissancePerturbation += perturbation * perturbation;
+                }
+            }
+            inverter.processHosted(sortie.data(), entree.data(), trames);
+            // La sortie du bloc atteint le micro d'erreur deux blocs plus tard
+            std::copy(sorties.begin() + trames, sorties.end(), sorties.begin());
+            for (unsigned int n = 0; n < trames; n++) {
+                sorties[retardSecondaire - trames + n] = sortie[2 * n];
+            }
+            // Laisser le thread d'adaptation suivre (environ 8x le temps réel)
+            if (bloc % 64 == 63) {
+                std::this_thread::sleep_for(std::chrono::microseconds(64 * trames * 1000000ull / 48000 / 8));
+            }
+        }
+        return 10.0 * std::log10((puissanceErreur + 1e-20) / (puissancePerturbation + 1e-20));
+    }
+};
+
+// Vérifie que le mode hybride atténue le bruit sur un chemin acoustique
+// simulé, et qu'il reprend après un passage en large bande
+int lancerVerificationHybride() {
+    const double seuilDb = -10.0;
+    NoiseInverter inverter(std::make_unique<NullBackend>());
+    inverter.setProfileLoading(false);
+    inverter.setVisualizationEnabled(false);
+    if (!inverter.prepareHosted(48000, SimulationAcoustique::trames, 2, 2)) {
+        return 1;
+    }
+    inverter.setEngineMode(NoiseInverter::HYBRID);
+    
+    SimulationAcoustique simulation;
+    const unsigned int blocsParSeconde = 48000 / SimulationAcoustique::trames;
+    double convergence = simulation.traiter(inverter, 10 * blocsParSeconde, blocsParSeconde);
+    
+    inverter.setEngineMode(NoiseInverter::BROADBAND);
+    double largeBande = simulation.traiter(inverter, blocsParSeconde, blocsParSeconde / 2);
+    
+    inverter.setEngineMode(NoiseInverter::HYBRID);
+    double reprise = simulation.traiter(inverter, 2 * blocsParSeconde, blocsParSeconde);
+    
+    HybridController::Status status = inverter.getHybridStatus();
+    inverter.releaseHosted();
+    
+    std::cout << "Hybride sur chemin simulé : atténuation " << convergence << " dB après convergence"
+              << ", " << largeBande << " dB en large bande"
+              << ", " << reprise << " dB au retour en hybride (seuil " << seuilDb << " dB)"
+              << ", replis " << status.backoffs << "\n";
+    bool reussie = convergence <= seuilDb && reprise <= seuilDb;
+    std::cout << (reussie ? "Vérification réussie" : "Vérification échouée") << "\n";
+    return reussie ? 0 : 1;
+}
+
+// Options du mode sans interface
+struct OptionsSansInterface {
+    std::string backend;
+    std::string fichierEntree;
+    std::string fichierSortie;
+    std::string format = "f32";
+    unsigned long long blocs = 0;
+    bool sansHorloge = false;
+    bool rythmeReel = false;
+    bool tamponAdaptatif = false;
+    bool profils = true;
+    unsigned int tailleTampon = 0;
+    float delai = -1.0f;
+    float gain = -1.0f;
+    int filtre = -1;
+    float fondamental = 0.0f;   // Mode tonal si > 0
+    unsigned int harmoniques = 0;
+    bool hybride = false;       // Entrée 2 = micro d'erreur
+    bool horlogesSeparees = false;  // null : entrée et sortie sur deux horloges
+    double derivePpm = 0.0;     // Écart de l'horloge d'entrée
+    unsigned int zones = 0;     // Hôte multizone si > 0
+    unsigned int threadsZones = 0;
+    bool evenements = false;    // Abonnement aux notifications du moteur
+};
+
+std::atomic<bool> arretDemande{false};
+
+void gestionnaireSignal(int) {
+    arretDemande = true;
+}
+
+// SIGUSR1 : export de la trace (écrit par le thread de surveillance)
+void gestionnaireExportTrace(int) {
+    trace::requestDump(trace::DUMP_ON_DEMAND);
+}
+
+// Active le traçage ; la trace complète est écrite dans fichier à la sortie
+std::string fichierTrace;
+
+void activerTrace(const std::string& fichier) {
+    fichierTrace = fichier;
+    trace::enable();
+    trace::setDumpPath(fichier);
+    trace::setThreadName("principal");
+    std::signal(SIGUSR1, gestionnaireExportTrace);
+}
+
+int terminerTrace(int code) {
+    if (!fichierTrace.empty()) {
+        trace::disable();
+        if (trace::dump(fichierTrace)) {
+            std::cerr << "Trace écrite: " << fichierTrace << "\n";
+        } else {
+            std::cerr << "Erreur: impossible d'écrire la trace " << fichierTrace << "\n";
+        }
+    }
+    return code;
+}
+
+// Hôte multizone : mêmes paramètres pour toutes les zones, filtres
+// alternés si aucun n'est imposé, pour des charges différentes
+int lancerZones(std::unique_ptr<AudioBackend> backend, const OptionsSansInterface& options,
+                NullBackend* nullBackend) {
+    if (!backend) {
+        backend = std::make_unique<RtAudioBackend>();
+    }
+    ZoneHost host(std::move(backend));
+    if (options.tailleTampon > 0) {
+        host.setBufferFrames(options.tailleTampon);
+    }
+    host.setWorkerCount(options.threadsZones);
+    
+    for (unsigned int z = 0; z < options.zones; z++) {
+        ZoneHost::ZoneConfig config;
+        config.inputChannels = options.hybride ? 2 : 1;
+        size_t index = host.addZone(config);
+        NoiseInverter& zone = host.zone(index);
+        int filtre = (options.filtre >= 0) ? options.filtre : static_cast<int>(z % 3);
+        zone.setParameters(options.delai, options.gain, -1.0f, -1.0f,
+                           static_cast<NoiseInverter::FilterType>(filtre));
+        if (options.fondamental > 0.0f) {
+            zone.setTonalParameters(options.fondamental, options.harmoniques);
+            zone.setEngineMode(NoiseInverter::TONAL);
+        }
+        if (options.hybride) {
+            zone.setEngineMode(NoiseInverter::HYBRID);
+        }
+    }
+    
+    if (!host.start(-1, -1)) {
+        return 1;
+    }
+    
+    std::signal(SIGINT, gestionnaireSignal);
+    std::signal(SIGTERM, gestionnaireSignal);
+    while (!arretDemande && !host.isStreamFinished()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        trace::serviceDumps();
+    }
+    host.stop();
+    
+    ZoneHost::Stats stats = host.getStats();
+    std::cerr << "Zones: " << stats.blocks << " blocs, " << stats.workers << " thread(s)"
+              << ", échéances manquées " << stats.missedDeadlines
+              << ", vols " << stats.steals
+              << ", charge max " << stats.maxLoad * 100.0 << " %\n";
+    for (size_t z = 0; z < host.zoneCount(); z++) {
+        ZoneHost::ZoneLoad load = host.getZoneLoad(z);
+        std::cerr << "  Zone " << z << ": charge moyenne " << load.averageLoad * 100.0 << " %"
+                  << ", max " << load.maxLoad * 100.0 << " %"
+                  << ", en retard " << load.lateBlocks
+                  << ", abandonnés " << load.shedBlocks << "\n";
+    }
+    
+    if (nullBackend) {
+        NullBackend::Stats nullStats = nullBackend->getStats();
+        std::cerr << "Callbacks: " << nullStats.callbacks
+                  << ", en retard: " << nullStats.lateCallbacks
+                  << ", retard max: " << nullStats.maxLatenessUs << " us\n";
+    }
+    
+    return 0;
+}
+
+// Mode sans interface : traite le flux du backend choisi jusqu'à la fin de
+// la source ou jusqu'à Ctrl-C
+int lancerSansInterface(const OptionsSansInterface& options) {
+    std::unique_ptr<AudioBackend> backend;
+    NullBackend* nullBackend = nullptr;
+    SplitDeviceBackend* splitBackend = nullptr;
+    
+    if (options.backend == "pipe") {
+        PipeBackend::SampleFormat format = (options.format == "s16") ? PipeBackend::INT16 : PipeBackend::FLOAT32;
+        backend = std::make_unique<PipeBackend>(format);
+    } else if (options.backend == "file") {
+        if (options.fichierEntree.empty() || options.fichierSortie.empty()) {
+            std::cerr << "Le backend fichier nécessite --in et --out\n";
+            return 1;
+        }
+        backend = std::make_unique<FileBackend>(options.fichierEntree, options.fichierSortie, options.rythmeReel);
+    } else if (options.backend == "null" && options.horlogesSeparees) {
+        auto capture = std::make_unique<NullBackend>(NullBackend::SINE, !options.sansHorloge);
+        capture->setClockSkew(options.derivePpm);
+        auto lecture = std::make_unique<NullBackend>(NullBackend::SILENCE, !options.sansHorloge, options.blocs);
+        nullBackend = lecture.get();
+        auto separe = std::make_unique<SplitDeviceBackend>(std::move(capture), std::move(lecture));
+        splitBackend = separe.get();
+        backend = std::move(separe);
+    } else if (options.backend == "null") {
+        auto backendNul = std::make_unique<NullBackend>(NullBackend::NOISE, !options.sansHorloge, options.blocs);
+        nullBackend = backendNul.get();
+        backend = std::move(backendNul);
+    } else if (options.backend != "rtaudio") {
+        std::cerr << "Backend inconnu: " << options.backend << "\n";
+        return 1;
+    }
+    
+    if (options.zones > 0) {
+        return lancerZones(std::move(backend), options, nullBackend);
+    }
+    
+    NoiseInverter inverter(std::move(backend));
+    if (options.profils) {
+        inverter.openProfileStore(ProfileStore::defaultDirectory());
+    }
+    if (options.tailleTampon > 0) {
+        inverter.setBufferFrames(options.tailleTampon);
+    }
+    if (options.tamponAdaptatif) {
+        inverter.setAdaptiveBufferSize(true);
+    }
+    
+    // Paramètres appliqués avant le démarrage : les backends hors temps réel
+    // peuvent traiter tout le flux avant le retour de start().
+    // Des paramètres explicites priment sur le profil enregistré.
+    NoiseInverter::FilterType type = inverter.getCurrentFilterType();
+    if (options.filtre == 0) type = NoiseInverter::BANDPASS;
+    else if (options.filtre == 1) type = NoiseInverter::LOWPASS;
+    else if (options.filtre == 2) type = NoiseInverter::HIGHPASS;
+    inverter.setParameters(options.delai, options.gain, -1.0f, -1.0f, type);
+    if (options.delai >= 0.0f || options.gain >= 0.0f || options.filtre >= 0) {
+        inverter.setProfileLoading(false);
+    }
+    if (options.fondamental > 0.0f) {
+        inverter.setTonalParameters(options.fondamental, options.harmoniques);
+        inverter.setEngineMode(NoiseInverter::TONAL);
+    }
+    if (options.hybride) {
+        inverter.setEngineMode(NoiseInverter::HYBRID);
+    }
+    
+    if (!inverter.start(-1, -1)) {
+        return 1;
+    }
+    
+    // Notifications attendues sur le descripteur de l'abonnement
+    std::shared_ptr<EventChannel::Subscription> abonnement;
+    unsigned long long reveils = 0, visualisations = 0, niveaux = 0, xruns = 0, parametres = 0;
+    if (options.evenements) {
+        inverter.setMeteringEnabled(true);
+        abonnement = inverter.getEventChannel().subscribe();
+    }
+    
+    std::signal(SIGINT, gestionnaireSignal);
+    std::signal(SIGTERM, gestionnaireSignal);
+    while (!arretDemande && !inverter.isStreamFinished()) {
+        if (abonnement) {
+            uint32_t evenements = abonnement->wait(50);
+            reveils += (evenements != 0);
+            visualisations += (evenements & EventChannel::VISUALIZATION) != 0;
+            niveaux += (evenements & EventChannel::METER) != 0;
+            xruns += (evenements & EventChannel::XRUN) != 0;
+            parametres += (evenements & EventChannel::PARAMETERS_APPLIED) != 0;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        trace::serviceDumps();
+    }
+    inverter.stop();
+    
+    if (abonnement) {
+        EventChannel& canal = inverter.getEventChannel();
+        std::cerr << "Événements: " << reveils << " réveil(s) de l'abonné"
+                  << " (visualisation " << visualisations << ", niveaux " << niveaux
+                  << ", xruns " << xruns << ", paramètres " << parametres << ")"
+                  << ", " << canal.getDispatchCount() << " distribution(s)"
+                  << ", " << canal.getWakeCount() << " réveil(s) par le thread audio\n";
+    }
+    
+    if (options.hybride) {
+        HybridController::Status status = inverter.getHybridStatus();
+        std::cerr << "Hybride: atténuation " << status.attenuationDb << " dB"
+                  << ", gain de boucle " << status.loopGain
+                  << ", replis " << status.backoffs
+                  << ", trames non adaptées " << status.droppedFrames << "\n";
+    }
+    
+    if (splitBackend) {
+        SplitDeviceBackend::Stats stats = splitBackend->getStats();
+        std::cerr << "Conversion asynchrone: dérive " << stats.driftPpm << " ppm"
+                  << ", file " << stats.fillFrames << " / " << stats.targetFrames << " trames"
+                  << ", manques " << stats.underruns
+                  << ", débordements " << stats.overruns << "\n";
+    }
+    
+    if (nullBackend) {
+        NullBackend::Stats stats = nullBackend->getStats();
+        std::cerr << "Callbacks: " << stats.callbacks
+                  << ", en retard: " << stats.lateCallbacks
+                  << ", retard max: " << stats.maxLatenessUs << " us"
+                  << ", durée moyenne: " << (stats.callbacks ? stats.totalCallbackUs / stats.callbacks : 0.0) << " us"
+                  << ", durée max: " << stats.maxCallbackUs << " us\n";
+    }
+    
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    // Options de ligne de commande
+    OptionsSansInterface options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+        if (arg == "--simulate") {
+            unsigned int blocs = 2000;
+            if (hasValue) {
+                blocs = static_cast<unsigned int>(std::stoul(argv[i + 1]));
+            }
+            return terminerTrace(lancerSimulation(blocs));
+        } else if (arg == "--compare-fixed") {
+            unsigned int blocs = 2000;
+            if (hasValue) {
+                blocs = static_cast<unsigned int>(std::stoul(argv[i + 1]));
+            }
+            return terminerTrace(lancerComparaisonVirguleFixe(blocs));
+        } else if (arg == "--audit-stream") {
+            unsigned int blocs = 750;
+            if (hasValue) {
+                blocs = static_cast<unsigned int>(std::stoul(argv[i + 1]));
+            }
+            return terminerTrace(lancerAuditFlux(blocs));
+        } else if (arg == "--hybrid-check") {
+            return terminerTrace(lancerVerificationHybride());
+        } else if (arg == "--watchdog-check") {
+            unsigned int cycles = 1;
+            if (hasValue) {
+                cycles = static_cast<unsigned int>(std::stoul(argv[i + 1]));
+            }
+            return terminerTrace(lancerVerificationSurveillance(cycles));
+        } else if (arg == "--trace" && hasValue) {
+            activerTrace(argv[++i]);
+        } else if (arg == "--backend" && hasValue) {
+            options.backend = argv[++i];
+        } else if (arg == "--in" && hasValue) {
+            options.fichierEntree = argv[++i];
+        } else if (arg == "--out" && hasValue) {
+            options.fichierSortie = argv[++i];
+        } else if (arg == "--format" && hasValue) {
+            options.format = argv[++i];
+        } else if (arg == "--blocks" && hasValue) {
+            options.blocs = std::stoull(argv[++i]);
+        } else if (arg == "--buffer" && hasValue) {
+            options.tailleTampon = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "--delay" && hasValue) {
+            options.delai = std::stof(argv[++i]);
+        } else if (arg == "--gain" && hasValue) {
+            options.gain = std::stof(argv[++i]);
+        } else if (arg == "--filter" && hasValue) {
+            options.filtre = std::stoi(argv[++i]);
+        } else if (arg == "--tonal" && hasValue) {
+            options.fondamental = std::stof(argv[++i]);
+        } else if (arg == "--harmonics" && hasValue) {
+            options.harmoniques = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "--hybrid") {
+            options.hybride = true;
+        } else if (arg == "--split-skew" && hasValue) {
+            options.horlogesSeparees = true;
+            options.derivePpm = std::stod(argv[++i]);
+        } else if (arg == "--zones" && hasValue) {
+            options.zones = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "--zone-workers" && hasValue) {
+            options.threadsZones = static_cast<unsigned int>(std::stoul(argv[++i]));
+        } else if (arg == "--events") {
+            options.evenements = true;
+        } else if (arg == "--unclocked") {
+            options.sansHorloge = true;
+        } else if (arg == "--paced") {
+            options.rythmeReel = true;
+        } else if (arg == "--adaptive-buffer") {
+            options.tamponAdaptatif = true;
+        } else if (arg == "--no-profiles") {
+            options.profils = false;
+        } else {
+            std::cerr << "Option inconnue: " << arg << "\n"
+                      << "Usage: noise_inverter [--trace trace.json] [--simulate [blocs]] [--compare-fixed [blocs]]\n"
+                      << "       noise_inverter --watchdog-check [cycles]  (pannes simulées, reprise du flux)\n"
+                      << "       noise_inverter --hybrid-check  (mode hybride sur chemin acoustique simulé)\n"
+                      << "       noise_inverter --audit-stream [blocs]  (audit temps réel d'un flux démarré)\n"
+                      << "       noise_inverter --backend rtaudio|pipe|file|null\n"
+                      << "           [--in entree.wav --out sortie.wav] [--paced]\n"
+                      << "           [--format f32|s16] [--blocks N] [--unclocked]\n"
+                      << "           [--buffer trames] [--adaptive-buffer] [--no-profiles]\n"
+                      << "           [--delay ms] [--gain g] [--filter 0|1|2]\n"
+                      << "           [--tonal f0_hz] [--harmonics n] [--hybrid]\n"
+                      << "           [--split-skew ppm]  (null : entrée sur une horloge décalée)\n"
+                      << "           [--zones N] [--zone-workers N]  (hôte multizone)\n"
+                      << "           [--events]  (abonnement aux notifications du moteur)\n";
+            return 1;
+        }
+    }
+    
+    if (!options.backend.empty()) {
+        return terminerTrace(lancerSansInterface(options));
+    }
+    
     std::cout << "=== NoiseInverter - Système d'annulation de bruit ===\n";
     std::cout << "Initialisation...\n";
     
     // Créer l'instance de NoiseInverter
-    NoiseInverter inverter;
+    NoiseInverter inverter(std::make_unique<RtAudioBackend>());
+    std::cout << "NoiseInverter initialisé - Optimisé pour Focusrite Firewire" << std::endl;
+    std::cout << "Taux d'échantillonnage: " << inverter.getSampleRate() << " Hz" << std::endl;
+    std::cout << "Taille du tampon: " << inverter.getBufferFrames() << " échantillons" << std::endl;
+    if (options.profils) {
+        inverter.openProfileStore(ProfileStore::defaultDirectory());
+    }
     
     // Variables pour stocker l'état et les sélections
     int choix = -1;
@@ -168,6 +811,38 @@ int main() {
                 break;
             }
             
+            case 6: {
+                // Mode d'annulation
+                int mode;
+                std::cout << "Mode (0=Large bande, 1=Tonal, 2=Hybride): ";
+                std::cin >> mode;
+                
+                if (mode == 2) {
+                    if (inverter.setEngineMode(NoiseInverter::HYBRID)) {
+                        std::cout << "Mode hybride activé (entrée 2 = micro d'erreur).\n";
+                    } else {
+                        std::cout << "Mode hybride sélectionné : redémarrer le traitement "
+                                  << "pour ouvrir l'entrée du micro d'erreur.\n";
+                    }
+                } else if (mode == 1) {
+                    float fondamental;
+                    unsigned int harmoniques;
+                    std::cout << "Fréquence fondamentale (Hz): ";
+                    std::cin >> fondamental;
+                    std::cout << "Nombre d'harmoniques (1-" << TonalCanceller::maxHarmonics << "): ";
+                    std::cin >> harmoniques;
+                    
+                    inverter.setTonalParameters(fondamental, harmoniques);
+                    inverter.setEngineMode(NoiseInverter::TONAL);
+                    std::cout << "Mode tonal activé.\n";
+                } else {
+                    inverter.setEngineMode(NoiseInverter::BROADBAND);
+                    std::cout << "Mode large bande activé.\n";
+                }
+                
+                break;
+            }
+            
             case 0:
                 // Quitter
                 if (running) {
@@ -185,8 +860,15 @@ int main() {
         // Montrer les informations de charge CPU si actif
         if (running) {
             std::cout << "Latence: " << inverter.getLatency() << " ms\n";
+            if (inverter.getEngineMode() == NoiseInverter::TONAL) {
+                std::cout << "Fondamental suivi: " << inverter.getTrackedFrequency() << " Hz\n";
+            } else if (inverter.getEngineMode() == NoiseInverter::HYBRID) {
+                HybridController::Status status = inverter.getHybridStatus();
+                std::cout << "Atténuation: " << status.attenuationDb << " dB, gain de boucle: "
+                          << status.loopGain << ", replis: " << status.backoffs << "\n";
+            }
         }
     }
     
-    return 0;
+    return terminerTrace(0);
 }
\ No newline at end of file